@@ -0,0 +1,892 @@
+#define JP_IMPLEMENTATION
+#include "../jp.h"
+
+#include "bench.h"
+
+volatile jsize_t bench_sink;
+
+// records shaped like examples/twitch-payload.c, indented with 4 spaces
+Buffer twitch_payloads(size_t count)
+{
+    Buffer buffer = {0};
+    buffer_printf(&buffer, "[\n");
+    for (size_t i = 0; i < count; ++i)
+    {
+        buffer_printf(&buffer,
+                      "    {\n"
+                      "        \"_id\": %zu,\n"
+                      "        \"bio\": \":)\",\n"
+                      "        \"created_at\": \"2013-06-03T19:12:02Z\",\n"
+                      "        \"display_name\": \"dallas\",\n"
+                      "        \"email\": \"email-address@provider.com\",\n"
+                      "        \"email_verified\": true,\n"
+                      "        \"logo\": \"https://www.test-url.net/abc/defg\",\n"
+                      "        \"name\": \"Ciremun\",\n"
+                      "        \"notifications\": {\n"
+                      "            \"email\": false,\n"
+                      "            \"push\": true\n"
+                      "        },\n"
+                      "        \"partnered\": false,\n"
+                      "        \"twitter_connected\": false,\n"
+                      "        \"type\": \"staff\",\n"
+                      "        \"updated_at\": \"2069-12-14T01:01:44Z\"\n"
+                      "    }%s\n",
+                      i, i + 1 < count ? "," : "");
+    }
+    buffer_printf(&buffer, "]\n");
+    return buffer;
+}
+
+// json_skip_whitespaces before it learned to skip whole blocks
+int skip_whitespaces_bytewise(JParser *parser)
+{
+    while (json_whitespace_char(parser->input[parser->pos]))
+        parser->pos++;
+    if (parser->input[parser->pos] == '\0')
+        return 0;
+    return 1;
+}
+
+// steps over every token like the parser would, only the whitespaces
+// between them are skipped with `skip`
+void walk_tokens(const char *input, int (*skip)(JParser *parser))
+{
+    JMemory memory = {0, bench_alloc};
+    JParser parser = json_init_parser(&memory, input);
+    while (skip(&parser))
+    {
+        while (!json_whitespace_char(input[parser.pos]) && input[parser.pos] != '\0')
+            parser.pos++;
+    }
+    bench_sink = parser.pos;
+}
+
+void walk_bytewise(const char *input)
+{
+    walk_tokens(input, skip_whitespaces_bytewise);
+}
+
+void walk(const char *input)
+{
+    walk_tokens(input, json_skip_whitespaces);
+}
+
+void parse(const char *input)
+{
+    JMemory memory = {0, bench_alloc};
+    JValue value = json_parse_custom(&memory, input);
+    bench_sink = value.type;
+}
+
+void bench_whitespaces(void)
+{
+    Buffer indented = twitch_payloads(50000);
+    Buffer minified = minify(indented.data);
+    const char *names[] = {"indented", "minified"};
+    Buffer inputs[] = {indented, minified};
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)",
+           "bytewise skip (ms)", "block skip (ms)", "parse (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", names[i], megabytes(inputs[i].length),
+               bench_time(10, walk_bytewise, inputs[i].data) * 1000.0,
+               bench_time(10, walk, inputs[i].data) * 1000.0,
+               bench_time(10, parse, inputs[i].data) * 1000.0);
+    }
+    free(indented.data);
+    free(minified.data);
+}
+
+// log records with long URLs and messages, mostly string bytes
+Buffer log_entries(size_t count, const char *open, const char *separator, const char *close)
+{
+    Buffer buffer = {0};
+    buffer_printf(&buffer, "%s", open);
+    for (size_t i = 0; i < count; ++i)
+    {
+        buffer_printf(&buffer,
+                      "{\"level\":\"info\",\"url\":\"https://www.test-url.net/api/v5/users/%zu/followers?cursor=eyJiIjpudWxsLCJhIjp7IkN1cnNvciI6IjE2MTk%%3D\","
+                      "\"message\":\"request %zu served from cache after revalidation, upstream answered with \\\"304 Not Modified\\\" in 12ms\","
+                      "\"user_agent\":\"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/96.0.4664.45 Safari/537.36\"}%s",
+                      i, i, i + 1 < count ? separator : "");
+    }
+    buffer_printf(&buffer, "%s", close);
+    return buffer;
+}
+
+Buffer log_records(size_t count)
+{
+    return log_entries(count, "[", ",", "]");
+}
+
+// finds the end of every string in the input one byte at a time
+void scan_strings_bytewise(const char *input)
+{
+    jsize_t pos = 0;
+    jsize_t strings = 0;
+    while (input[pos] != '\0')
+    {
+        if (input[pos++] != '"')
+            continue;
+        while (input[pos] != '"')
+            pos += input[pos] == '\\' ? 2 : 1;
+        pos++;
+        strings++;
+    }
+    bench_sink = strings;
+}
+
+void scan_strings(const char *input)
+{
+    jsize_t pos = 0;
+    jsize_t strings = 0;
+    while (input[pos] != '\0')
+    {
+        if (input[pos++] != '"')
+            continue;
+        for (;;)
+        {
+            pos = json_scan_string(input, pos, JSON_NUL_TERMINATED);
+            if (input[pos] != '\\')
+                break;
+            pos += 2;
+        }
+        pos++;
+        strings++;
+    }
+    bench_sink = strings;
+}
+
+void bench_strings(void)
+{
+    Buffer records = log_records(100000);
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)",
+           "bytewise scan (ms)", "block scan (ms)", "parse (ms)");
+    printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", "logs", megabytes(records.length),
+           bench_time(10, scan_strings_bytewise, records.data) * 1000.0,
+           bench_time(10, scan_strings, records.data) * 1000.0,
+           bench_time(10, parse, records.data) * 1000.0);
+    free(records.data);
+}
+
+// GeoJSON line strings, almost every token is a double
+Buffer geo_features(size_t count)
+{
+    Buffer buffer = {0};
+    unsigned long long state = 42;
+    buffer_printf(&buffer, "{\"type\":\"FeatureCollection\",\"features\":[");
+    for (size_t i = 0; i < count; ++i)
+    {
+        buffer_printf(&buffer, "{\"type\":\"Feature\",\"properties\":{\"speed\":%.3f},"
+                               "\"geometry\":{\"type\":\"LineString\",\"coordinates\":[",
+                      (double)(i % 1000) / 7.0);
+        for (int point = 0; point < 16; ++point)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            double longitude = (double)(state >> 11) / 9007199254740992.0 * 360.0 - 180.0;
+            double latitude = (double)(state & 0xFFFFFFFF) / 4294967296.0 * 180.0 - 90.0;
+            buffer_printf(&buffer, "%s[%.15g,%.7f]", point ? "," : "", longitude, latitude);
+        }
+        buffer_printf(&buffer, "]}}%s", i + 1 < count ? "," : "");
+    }
+    buffer_printf(&buffer, "]}");
+    return buffer;
+}
+
+// converts every number in the input, `convert` returns the end of it
+void convert_numbers(const char *input, const char *(*convert)(const char *number, double *result))
+{
+    double sum = 0.0;
+    for (const char *c = input; *c;)
+    {
+        if (*c == '"')
+        {
+            c = strchr(c + 1, '"') + 1;
+            continue;
+        }
+        if (*c != '-' && (*c < '0' || *c > '9'))
+        {
+            c++;
+            continue;
+        }
+        double result;
+        c = convert(c, &result);
+        sum += result;
+    }
+    bench_sink = (jsize_t)sum;
+}
+
+const char *convert_strtod(const char *number, double *result)
+{
+    char *end;
+    *result = strtod(number, &end);
+    return end;
+}
+
+const char *convert_json(const char *number, double *result)
+{
+    JNumber parts;
+    jsize_t end;
+    json_scan_number(number, 0, JSON_NUL_TERMINATED, &parts, &end);
+    *result = json_number_to_double(&parts, number, end);
+    return number + end;
+}
+
+void numbers_strtod(const char *input)
+{
+    convert_numbers(input, convert_strtod);
+}
+
+void numbers_json(const char *input)
+{
+    convert_numbers(input, convert_json);
+}
+
+void bench_floats(void)
+{
+    Buffer features = geo_features(50000);
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)",
+           "strtod (ms)", "fast path (ms)", "parse (ms)");
+    printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", "geojson", megabytes(features.length),
+           bench_time(10, numbers_strtod, features.data) * 1000.0,
+           bench_time(10, numbers_json, features.data) * 1000.0,
+           bench_time(10, parse, features.data) * 1000.0);
+    free(features.data);
+}
+
+// rows of snowflake ids and counters, almost every byte is a digit
+Buffer id_records(size_t count)
+{
+    Buffer buffer = {0};
+    buffer_printf(&buffer, "[");
+    for (size_t i = 0; i < count; ++i)
+    {
+        unsigned long long id = 1100000000000000000ULL + i * 7919;
+        buffer_printf(&buffer, "[%llu,%llu,%llu,%zu,%zu,%llu]%s", id, id - 104729, id + 15485863, i * 31 % 1000003,
+                      i % 977, 1600000000000ULL + i, i + 1 < count ? "," : "");
+    }
+    buffer_printf(&buffer, "]");
+    return buffer;
+}
+
+// json_parse_number before the 8 digit blocks, finds the delimiter first
+// and then adds up the digits one at a time
+const char *convert_bytewise(const char *number, double *result)
+{
+    jsize_t length = 0;
+    while (!json_whitespace_char(number[length]) && number[length] != ',' && number[length] != '}' &&
+           number[length] != ']' && number[length] != '\0')
+        length++;
+    unsigned long long value = 0;
+    for (jsize_t i = 0; i < length; ++i)
+        value = value * 10 + (unsigned long long)(number[i] - '0');
+    *result = (double)value;
+    return number + length;
+}
+
+const char *convert_integer(const char *number, double *result)
+{
+    JNumber parts;
+    jsize_t end;
+    json_scan_number(number, 0, JSON_NUL_TERMINATED, &parts, &end);
+    *result = (double)parts.mantissa;
+    return number + end;
+}
+
+void numbers_bytewise(const char *input)
+{
+    convert_numbers(input, convert_bytewise);
+}
+
+void numbers_integer(const char *input)
+{
+    convert_numbers(input, convert_integer);
+}
+
+void bench_integers(void)
+{
+    Buffer records = id_records(500000);
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)",
+           "bytewise (ms)", "8 digits (ms)", "parse (ms)");
+    printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", "ids", megabytes(records.length),
+           bench_time(10, numbers_bytewise, records.data) * 1000.0,
+           bench_time(10, numbers_integer, records.data) * 1000.0,
+           bench_time(10, parse, records.data) * 1000.0);
+    free(records.data);
+}
+
+void parse_lazy(const char *input)
+{
+    JMemory memory = {0, bench_alloc};
+    JValue value = json_parse_flags(&memory, input, JSON_LAZY_NUMBERS);
+    bench_sink = value.type;
+}
+
+void bench_lazy(void)
+{
+    Buffer features = geo_features(50000);
+    Buffer records = id_records(500000);
+    const char *names[] = {"geojson", "ids"};
+    Buffer inputs[] = {features, records};
+    printf("%-10s %10s %18s %18s\n", "input", "size (MB)", "parse (ms)", "lazy parse (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        printf("%-10s %10.2f %18.2f %18.2f\n", names[i], megabytes(inputs[i].length),
+               bench_time(10, parse, inputs[i].data) * 1000.0,
+               bench_time(10, parse_lazy, inputs[i].data) * 1000.0);
+    }
+    free(features.data);
+    free(records.data);
+}
+
+// wide records where a handler only reads a few of the fields
+Buffer wide_records(size_t count)
+{
+    Buffer buffer = {0};
+    buffer_printf(&buffer, "[");
+    for (size_t i = 0; i < count; ++i)
+    {
+        buffer_printf(&buffer, "{\"id\":%zu", i);
+        for (int field = 0; field < 200; ++field)
+            buffer_printf(&buffer, ",\"field_%d\":%s", field,
+                          field % 3 == 0 ? "\"some string value\"" : field % 3 == 1 ? "[1,2,{\"x\":3}]" : "12345.5");
+        buffer_printf(&buffer, ",\"name\":\"user %zu\",\"active\":true}%s", i, i + 1 < count ? "," : "");
+    }
+    buffer_printf(&buffer, "]");
+    return buffer;
+}
+
+void read_fields_parse(const char *input)
+{
+    JMemory memory = {0, bench_alloc};
+    JValue records = json_parse_custom(&memory, input);
+    long long sum = 0;
+    for (jsize_t i = 0; i < records.array.length; ++i)
+    {
+        JValue id = json_get(&records.array.data[i].object, "id");
+        JValue name = json_get(&records.array.data[i].object, "name");
+        JValue active = json_get(&records.array.data[i].object, "active");
+        sum += id.number + (long long)name.string.length + active.boolean;
+    }
+    bench_sink = (jsize_t)sum;
+}
+
+void read_fields_cursor(const char *input)
+{
+    JArena arena = json_arena_init();
+    JCursor records = json_cursor_begin(&arena, input, JSON_NUL_TERMINATED);
+    JCursor record;
+    long long sum = 0;
+    while (json_cursor_next_element(&records, &record) == 1)
+    {
+        long long id = 0;
+        JString name = {0};
+        int active = 0;
+        JCursor id_cursor = json_cursor_find_field(&record, "id");
+        JCursor name_cursor = json_cursor_find_field(&record, "name");
+        JCursor active_cursor = json_cursor_find_field(&record, "active");
+        json_cursor_get_int(&id_cursor, &id);
+        json_cursor_get_string(&name_cursor, &name);
+        json_cursor_get_bool(&active_cursor, &active);
+        sum += id + (long long)name.length + active;
+    }
+    json_arena_free(&arena);
+    bench_sink = (jsize_t)sum;
+}
+
+void bench_cursor(void)
+{
+    Buffer records = wide_records(5000);
+    printf("%-10s %10s %18s %18s\n", "input", "size (MB)", "parse (ms)", "cursor (ms)");
+    printf("%-10s %10.2f %18.2f %18.2f\n", "wide", megabytes(records.length),
+           bench_time(10, read_fields_parse, records.data) * 1000.0,
+           bench_time(10, read_fields_cursor, records.data) * 1000.0);
+    free(records.data);
+}
+
+// json_skip_value for containers before it learned to skip whole blocks
+int skip_bytewise(JParser *parser)
+{
+    jsize_t depth = 0;
+    for (;;)
+    {
+        char c = json_peek(parser);
+        if (c == '"')
+        {
+            int skipped = json_skip_string(parser);
+            if (skipped != 1)
+                return skipped;
+            continue;
+        }
+        if (c == '\0')
+            return JSON_UNEXPECTED_EOF;
+        parser->pos++;
+        if (c == '{' || c == '[')
+            depth++;
+        else if ((c == '}' || c == ']') && --depth == 0)
+            return 1;
+    }
+}
+
+void skip_with(const char *input, int (*skip)(JParser *parser))
+{
+    JMemory memory = {0, bench_alloc};
+    JParser parser = json_init_parser(&memory, input);
+    skip(&parser);
+    bench_sink = parser.pos;
+}
+
+void skip_value_bytewise(const char *input)
+{
+    skip_with(input, skip_bytewise);
+}
+
+void skip_value(const char *input)
+{
+    skip_with(input, json_skip_value);
+}
+
+void bench_skip(void)
+{
+    Buffer wide = wide_records(5000);
+    Buffer indented = twitch_payloads(50000);
+    Buffer features = geo_features(50000);
+    const char *names[] = {"wide", "indented", "geojson"};
+    Buffer inputs[] = {wide, indented, features};
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)", "bytewise (ms)", "block skip (ms)", "parse (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", names[i], megabytes(inputs[i].length),
+               bench_time(10, skip_value_bytewise, inputs[i].data) * 1000.0,
+               bench_time(10, skip_value, inputs[i].data) * 1000.0,
+               bench_time(10, parse, inputs[i].data) * 1000.0);
+        free(inputs[i].data);
+    }
+}
+
+// feeds the input in chunks like a network layer would hand them over
+void stream_chunks(const char *input, jsize_t chunk_size)
+{
+    JArena arena = json_arena_init_custom(bench_alloc, 0);
+    JStreamParser stream = json_stream_init(&arena);
+    jsize_t length = strlen(input);
+    for (jsize_t pos = 0; pos < length; pos += chunk_size)
+        json_stream_feed(&stream, input + pos, length - pos < chunk_size ? length - pos : chunk_size);
+    bench_sink = json_stream_finish(&stream).type;
+}
+
+void stream_4k(const char *input)
+{
+    stream_chunks(input, 4 * 1024);
+}
+
+void stream_64k(const char *input)
+{
+    stream_chunks(input, 64 * 1024);
+}
+
+void bench_stream(void)
+{
+    Buffer indented = twitch_payloads(50000);
+    Buffer logs = log_records(50000);
+    Buffer features = geo_features(50000);
+    const char *names[] = {"indented", "logs", "geojson"};
+    Buffer inputs[] = {indented, logs, features};
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)", "parse (ms)", "4 KiB chunks (ms)", "64 KiB chunks (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        printf("%-10s %10.2f %18.2f %18.2f %18.2f\n", names[i], megabytes(inputs[i].length),
+               bench_time(10, parse, inputs[i].data) * 1000.0,
+               bench_time(10, stream_4k, inputs[i].data) * 1000.0,
+               bench_time(10, stream_64k, inputs[i].data) * 1000.0);
+        free(inputs[i].data);
+    }
+}
+
+// the records of log_records one per line
+Buffer log_lines(size_t count)
+{
+    return log_entries(count, "", "\n", "\n");
+}
+
+void count_record(void *user, jsize_t line, JValue value)
+{
+    (void)user;
+    (void)line;
+    bench_sink += value.type;
+}
+
+void lines_json_parse(const char *input)
+{
+    JMemory memory = {0, bench_alloc};
+    const char *line = input;
+    for (const char *end; (end = strchr(line, '\n')) != 0; line = end + 1)
+        count_record(0, 0, json_parse_custom_n(&memory, line, (jsize_t)(end - line), 0));
+}
+
+void lines_batch(const char *input)
+{
+    JArena arena = json_arena_init_custom(bench_alloc, 0);
+    json_parse_lines_custom(&arena, input, strlen(input), 0, count_record, 0);
+}
+
+void bench_lines(void)
+{
+    Buffer lines = log_lines(100000);
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)", "per line (ms)", "batch (ms)", "memory (MB)");
+    double per_line = bench_time(10, lines_json_parse, lines.data) * 1000.0;
+    double per_line_memory = megabytes(bench_memory_used);
+    double batch = bench_time(10, lines_batch, lines.data) * 1000.0;
+    printf("%-10s %10.2f %18.2f %18.2f %10.2f -> %.2f\n", "logs", megabytes(lines.length),
+           per_line, batch, per_line_memory, megabytes(bench_memory_used));
+    free(lines.data);
+}
+
+int bench_threads = 1;
+
+void lines_parallel(const char *input)
+{
+    JArena arena = json_arena_init_custom(bench_alloc_shared, 0);
+    json_parse_lines_parallel(&arena, input, strlen(input), 0, bench_threads, count_record, 0);
+}
+
+void lines_parallel_unordered(const char *input)
+{
+    JArena arena = json_arena_init_custom(bench_alloc_shared, 0);
+    json_parse_lines_parallel(&arena, input, strlen(input), JSON_LINES_UNORDERED, bench_threads, count_record, 0);
+}
+
+void bench_parallel_lines(void)
+{
+    Buffer lines = log_lines(200000);
+    const int threads[] = {1, 2, 4, 8, 16, 32};
+    printf("%-10s %10s %18s %18s\n", "threads", "size (MB)", "in order (MB/s)", "unordered (MB/s)");
+    for (size_t i = 0; i < COUNT(threads); ++i)
+    {
+        bench_threads = threads[i];
+        printf("%-10d %10.2f %18.2f %18.2f\n", threads[i], megabytes(lines.length),
+               megabytes(lines.length) / bench_time(5, lines_parallel, lines.data),
+               megabytes(lines.length) / bench_time(5, lines_parallel_unordered, lines.data));
+    }
+    free(lines.data);
+}
+
+void parse_parallel(const char *input)
+{
+    JArena arena = json_arena_init_custom(bench_alloc_shared, 0);
+    bench_sink = json_parse_parallel(&arena, input, strlen(input), 0, bench_threads).type;
+}
+
+void index_elements(const char *input)
+{
+    JMemory memory = {0, bench_alloc};
+    JParser parser = json_init_parser(&memory, input);
+    jsize_t count = 0;
+    json_index_elements(&parser, &count);
+    bench_sink = count;
+}
+
+void bench_parallel(void)
+{
+    Buffer indented = twitch_payloads(100000);
+    Buffer logs = log_records(200000);
+    const char *names[] = {"indented", "logs"};
+    Buffer inputs[] = {indented, logs};
+    const int threads[] = {1, 2, 4, 8, 16, 32};
+    printf("%-10s %10s %10s %18s %18s\n", "input", "size (MB)", "threads", "parse (MB/s)", "index (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        double size = megabytes(inputs[i].length);
+        printf("%-10s %10.2f %10s %18.2f %18.2f\n", names[i], size, "json_parse", size / bench_time(5, parse, inputs[i].data),
+               bench_time(5, index_elements, inputs[i].data) * 1000.0);
+        for (size_t j = 0; j < COUNT(threads); ++j)
+        {
+            bench_threads = threads[j];
+            printf("%-10s %10.2f %10d %18.2f\n", names[i], size, threads[j], size / bench_time(5, parse_parallel, inputs[i].data));
+        }
+        free(inputs[i].data);
+    }
+}
+
+// the file is copied into the heap first, like read_file_as_str in tests
+void file_read(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *input = (char *)malloc(size);
+    bench_sink = fread(input, 1, size, f);
+    fclose(f);
+    JMemory memory = {0, bench_alloc};
+    bench_sink = json_parse_custom_n(&memory, input, size, JSON_ZERO_COPY).type;
+    free(input);
+}
+
+void file_map(const char *path)
+{
+    JMemory memory = {0, bench_alloc};
+    JFile file;
+    bench_sink = json_parse_file_custom(&memory, path, JSON_ZERO_COPY, &file).type;
+    json_unmap_file(&file);
+}
+
+void bench_file(void)
+{
+    const char *path = "bench_file.json";
+    Buffer payloads = twitch_payloads(200000);
+    FILE *f = fopen(path, "wb");
+    fwrite(payloads.data, 1, payloads.length, f);
+    fclose(f);
+    printf("%-10s %10s %18s %18s\n", "input", "size (MB)", "fread (ms)", "mmap (ms)");
+    printf("%-10s %10.2f %18.2f %18.2f\n", "indented", megabytes(payloads.length),
+           bench_time(5, file_read, path) * 1000.0, bench_time(5, file_map, path) * 1000.0);
+    remove(path);
+    free(payloads.data);
+}
+
+void count_event(void *user)
+{
+    (void)user;
+    bench_sink++;
+}
+
+void count_string(void *user, const char *string, jsize_t length)
+{
+    (void)string;
+    (void)user;
+    bench_sink += length;
+}
+
+void sax_parse(const char *input)
+{
+    JHandler handler = {0};
+    handler.on_object_begin = count_event;
+    handler.on_array_begin = count_event;
+    handler.on_key = count_string;
+    handler.on_string = count_string;
+    JArena arena = json_arena_init_custom(bench_alloc, 0);
+    json_sax_parse_custom(&arena, input, strlen(input), 0, &handler, 0);
+}
+
+void bench_sax(void)
+{
+    Buffer indented = twitch_payloads(100000);
+    Buffer logs = log_records(100000);
+    const char *names[] = {"indented", "logs"};
+    Buffer inputs[] = {indented, logs};
+    printf("%-10s %10s %18s %18s %18s\n", "input", "size (MB)", "json_parse (MB/s)", "sax (MB/s)", "memory (MB)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        double size = megabytes(inputs[i].length);
+        double dom = size / bench_time(5, parse, inputs[i].data);
+        double dom_memory = megabytes(bench_memory_used);
+        double sax = size / bench_time(5, sax_parse, inputs[i].data);
+        printf("%-10s %10.2f %18.2f %18.2f %10.2f -> %.2f\n", names[i], size, dom, sax, dom_memory,
+               megabytes(bench_memory_used));
+        free(inputs[i].data);
+    }
+}
+
+size_t bench_allocations = 0;
+
+void *bench_alloc_counted(size_t size)
+{
+    bench_allocations++;
+    return bench_alloc(size);
+}
+
+void parse_counted(const char *input)
+{
+    JMemory memory = {0, bench_alloc_counted};
+    bench_sink = json_parse_custom(&memory, input).type;
+}
+
+void tape_parse(const char *input)
+{
+    JTape tape;
+    bench_sink = json_parse_tape_custom(bench_alloc_counted, 0, input, JSON_NUL_TERMINATED, 0, &tape);
+}
+
+JValue walked_tree;
+JTape walked_tape;
+
+// sums every "_id" of the payloads
+void tree_walk(const char *input)
+{
+    (void)input;
+    long long sum = 0;
+    for (jsize_t i = 0; i < walked_tree.array.length; ++i)
+        sum += json_get(&walked_tree.array.data[i].object, "_id").number;
+    bench_sink = sum;
+}
+
+void tape_walk(const char *input)
+{
+    (void)input;
+    long long sum = 0;
+    JTapeValue root = json_tape_root(&walked_tape);
+    JTapeValue payload;
+    while (json_tape_next_element(&root, &payload) == 1)
+    {
+        JTapeValue id = json_tape_get(&payload, "_id");
+        sum += json_tape_value(&id).number;
+    }
+    bench_sink = sum;
+}
+
+void bench_tape(void)
+{
+    Buffer payloads = twitch_payloads(100000);
+    double size = megabytes(payloads.length);
+    printf("%-10s %10s %14s %14s %14s %14s\n", "format", "size (MB)", "parse (MB/s)", "memory (MB)", "allocations",
+           "walk (ms)");
+    bench_allocations = 0;
+    double tree_parse = size / bench_time(1, parse_counted, payloads.data);
+    size_t tree_allocations = bench_allocations;
+    double tree_memory = megabytes(bench_memory_used);
+    JMemory memory = {0, malloc};
+    walked_tree = json_parse_custom(&memory, payloads.data);
+    printf("%-10s %10.2f %14.2f %14.2f %14zu %14.2f\n", "tree", size, tree_parse, tree_memory, tree_allocations,
+           bench_time(5, tree_walk, 0) * 1000.0);
+    bench_allocations = 0;
+    double tape_parse_speed = size / bench_time(1, tape_parse, payloads.data);
+    size_t tape_allocations = bench_allocations;
+    double tape_memory = megabytes(bench_memory_used);
+    json_parse_tape_custom(malloc, free, payloads.data, payloads.length, 0, &walked_tape);
+    printf("%-10s %10.2f %14.2f %14.2f %14zu %14.2f\n", "tape", size, tape_parse_speed, tape_memory, tape_allocations,
+           bench_time(5, tape_walk, 0) * 1000.0);
+    json_tape_free(&walked_tape);
+    free(payloads.data);
+}
+
+// visits every node, strings are read through their length
+jsize_t walk_value(JValue value)
+{
+    jsize_t sum = value.type;
+    if (value.type == JSON_OBJECT)
+    {
+        for (jsize_t i = 0; i < value.object.length; ++i)
+            sum += value.object.data[i].key_length + walk_value(value.object.data[i].value);
+    }
+    else if (value.type == JSON_ARRAY)
+    {
+        for (jsize_t i = 0; i < value.array.length; ++i)
+            sum += walk_value(value.array.data[i]);
+    }
+    else if (value.type == JSON_STRING)
+        sum += value.string.length;
+    return sum;
+}
+
+void walk_tree(const char *input)
+{
+    (void)input;
+    for (int i = 0; i < 10; ++i)
+        bench_sink = walk_value(walked_tree);
+}
+
+// build with -DJP_COMPACT to compare the layouts
+void bench_layout(void)
+{
+    Buffer payloads = twitch_payloads(100000);
+    Buffer features = geo_features(50000);
+    Buffer small = twitch_payloads(200);
+    const char *names[] = {"indented", "geojson", "small"};
+    Buffer inputs[] = {payloads, features, small};
+    printf("sizeof(JValue) %zu, sizeof(JPair) %zu\n", sizeof(JValue), sizeof(JPair));
+    printf("%-10s %10s %14s %14s %14s\n", "input", "size (MB)", "parse (MB/s)", "tree (MB)", "10 walks (ms)");
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        double size = megabytes(inputs[i].length);
+        double speed = size / bench_time(5, parse, inputs[i].data);
+        double tree = megabytes(bench_memory_used);
+        JMemory memory = {0, malloc};
+        walked_tree = json_parse_custom(&memory, inputs[i].data);
+        printf("%-10s %10.2f %14.2f %14.3f %14.3f\n", names[i], size, speed, tree,
+               bench_time(5, walk_tree, 0) * 1000.0);
+        free(inputs[i].data);
+    }
+}
+
+size_t arena_mallocs = 0;
+
+void *arena_malloc_counted(size_t size)
+{
+    arena_mallocs++;
+    return malloc(size);
+}
+
+// the tree of every document is leaked, like a caller of json_parse_custom
+// that never frees would
+void documents_malloc(const char *input)
+{
+    JMemory memory = {0, arena_malloc_counted};
+    for (int i = 0; i < 2000; ++i)
+        bench_sink += json_parse_custom(&memory, input).type;
+}
+
+void documents_arena(const char *input)
+{
+    JArena arena = json_arena_init_custom(arena_malloc_counted, free);
+    for (int i = 0; i < 2000; ++i)
+    {
+        json_arena_reset(&arena);
+        bench_sink += json_parse_arena(&arena, input, JSON_NUL_TERMINATED, 0).type;
+    }
+    json_arena_free(&arena);
+}
+
+void documents_reuse(const char *input)
+{
+    JDocument document = json_init_document(json_arena_init_custom(arena_malloc_counted, free));
+    for (int i = 0; i < 2000; ++i)
+        bench_sink += json_parse_reuse(&document, input, JSON_NUL_TERMINATED, 0).type;
+    json_free(&document);
+}
+
+void bench_arena(void)
+{
+    Buffer small = twitch_payloads(20);
+    printf("%-10s %10s %18s %14s\n", "allocator", "size (KB)", "2000 parses (ms)", "allocations");
+    void (*parses[])(const char *) = {documents_malloc, documents_arena, documents_reuse};
+    const char *names[] = {"malloc", "arena", "reuse"};
+    for (size_t i = 0; i < COUNT(parses); ++i)
+    {
+        arena_mallocs = 0;
+        double elapsed = bench_time(1, parses[i], small.data) * 1000.0;
+        printf("%-10s %10.2f %18.2f %14zu\n", names[i], (double)small.length / 1024.0, elapsed, arena_mallocs);
+    }
+    free(small.data);
+}
+
+Bench benches[] = {
+    { .name = "whitespaces", .f = bench_whitespaces },
+    { .name = "strings", .f = bench_strings },
+    { .name = "floats", .f = bench_floats },
+    { .name = "integers", .f = bench_integers },
+    { .name = "lazy", .f = bench_lazy },
+    { .name = "cursor", .f = bench_cursor },
+    { .name = "skip", .f = bench_skip },
+    { .name = "stream", .f = bench_stream },
+    { .name = "lines", .f = bench_lines },
+    { .name = "parallel lines", .f = bench_parallel_lines },
+    { .name = "parallel", .f = bench_parallel },
+    { .name = "file", .f = bench_file },
+    { .name = "sax", .f = bench_sax },
+    { .name = "tape", .f = bench_tape },
+    { .name = "layout", .f = bench_layout },
+    { .name = "arena", .f = bench_arena },
+};
+
+int main(int argc, char **argv)
+{
+    for (size_t i = 0; i < COUNT(benches); ++i)
+    {
+        if (argc > 1 && strcmp(argv[1], benches[i].name) != 0)
+            continue;
+        printf("bench %s\n", benches[i].name);
+        benches[i].f();
+    }
+    return 0;
+}
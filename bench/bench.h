@@ -0,0 +1,135 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT(a) (sizeof(a) / sizeof(*a))
+
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+} Buffer;
+
+typedef struct
+{
+    const char *name;
+    void (*f)(void);
+} Bench;
+
+char *bench_memory = 0;
+size_t bench_memory_used = 0;
+size_t bench_memory_capacity = 0;
+
+void *bench_alloc(size_t size)
+{
+    size = (size + 7) & ~(size_t)7;
+    if (bench_memory_used + size > bench_memory_capacity)
+    {
+        fprintf(stderr, "bench memory exhausted\n");
+        exit(1);
+    }
+    bench_memory_used += size;
+    return bench_memory + bench_memory_used - size;
+}
+
+// bench_alloc for workers that allocate at the same time
+void *bench_alloc_shared(size_t size)
+{
+    size = (size + 7) & ~(size_t)7;
+#if defined(_MSC_VER)
+    size_t used = (size_t)_InterlockedExchangeAdd64((volatile long long *)&bench_memory_used, (long long)size) + size;
+#else
+    size_t used = __atomic_add_fetch(&bench_memory_used, size, __ATOMIC_RELAXED);
+#endif
+    if (used > bench_memory_capacity)
+    {
+        fprintf(stderr, "bench memory exhausted\n");
+        exit(1);
+    }
+    return bench_memory + used - size;
+}
+
+void bench_reset(void)
+{
+    if (bench_memory == 0)
+    {
+        bench_memory_capacity = 1024 * 1024 * 1024;
+        bench_memory = (char *)malloc(bench_memory_capacity);
+    }
+    bench_memory_used = 0;
+}
+
+double bench_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void buffer_append(Buffer *buffer, const char *data, size_t length)
+{
+    if (buffer->length + length + 1 > buffer->capacity)
+    {
+        buffer->capacity = (buffer->length + length + 1) * 2;
+        buffer->data = (char *)realloc(buffer->data, buffer->capacity);
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+}
+
+void buffer_printf(Buffer *buffer, const char *format, ...)
+{
+    char line[1024];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    buffer_append(buffer, line, (size_t)length);
+}
+
+// removes whitespaces outside of strings
+Buffer minify(const char *input)
+{
+    Buffer minified = {0};
+    int in_string = 0;
+    for (const char *c = input; *c; ++c)
+    {
+        if (in_string && *c == '\\')
+        {
+            buffer_append(&minified, c, 2);
+            c++;
+            continue;
+        }
+        if (*c == '"')
+            in_string = !in_string;
+        if (!in_string && (*c == ' ' || *c == '\n' || *c == '\t' || *c == '\r'))
+            continue;
+        buffer_append(&minified, c, 1);
+    }
+    return minified;
+}
+
+// seconds of the best of `repeat` runs of `f`
+double bench_time(int repeat, void (*f)(const char *), const char *input)
+{
+    double best = 1e30;
+    for (int i = 0; i < repeat; ++i)
+    {
+        bench_reset();
+        double start = bench_now();
+        f(input);
+        double elapsed = bench_now() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+double megabytes(size_t bytes)
+{
+    return (double)bytes / (1024.0 * 1024.0);
+}
@@ -34,6 +34,7 @@ const char *json_error_to_string(JCode error)
         case JSON_PARSE_ERROR:    return "JSON_PARSE_ERROR";
         case JSON_TYPE_ERROR:     return "JSON_TYPE_ERROR";
         case JSON_MEMORY_ERROR:   return "JSON_MEMORY_ERROR";
+        case JSON_RANGE_ERROR:    return "JSON_RANGE_ERROR";
     }
     return "UNKNOWN";
 }
@@ -49,6 +50,9 @@ const char *json_type_to_string(JType type)
         case JSON_NUMBER: return "number";
         case JSON_ARRAY:  return "array";
         case JSON_ERROR:  return "error";
+        case JSON_DOUBLE: return "number";
+        case JSON_UNSIGNED: return "number";
+        case JSON_BIGNUM: return "number";
     }
     return "UNKNOWN";
 }
@@ -87,6 +91,13 @@ void json_number_to_string(long long number)
     output_result(string);
 }
 
+void json_double_to_string(double real)
+{
+    char string[512];
+    stbsp_snprintf(string, 512, "%.17g", real);
+    output_result(string);
+}
+
 void json_array_to_string(JArray array)
 {
     output_result("[");
@@ -131,6 +142,17 @@ void json_value_to_string(JValue value)
         case JSON_STRING: {
             json_string_to_string(value.string);
         } break;
+        case JSON_DOUBLE: {
+            json_double_to_string(value.real);
+        } break;
+        case JSON_UNSIGNED: {
+            char string[512];
+            stbsp_snprintf(string, 512, "%llu", value.unsigned_number);
+            output_result(string);
+        } break;
+        case JSON_BIGNUM: {
+            output_result(value.string.data);
+        } break;
     }
 }
 
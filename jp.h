@@ -1,6 +1,12 @@
 #ifndef JP_H_
 #define JP_H_
 
+// strict C modes hide madvise, see json_map_file, this only works when jp.h
+// comes before the other system headers
+#if !defined(NOSTDLIB) && !defined(JP_NO_MMAP) && !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif // _DEFAULT_SOURCE
+
 #if !defined(NDEBUG)
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +17,10 @@
 #ifndef JP_DEFAULT_ALLOC
 #include <stdlib.h>
 #define JP_DEFAULT_ALLOC malloc
+// a custom JP_DEFAULT_ALLOC without a JP_DEFAULT_FREE never gets chunks back
+#ifndef JP_DEFAULT_FREE
+#define JP_DEFAULT_FREE free
+#endif // JP_DEFAULT_FREE
 #endif // JP_DEFAULT_ALLOC
 
 #ifndef JP_ALLOC_SIZE_TYPE
@@ -18,17 +28,108 @@
 #define JP_ALLOC_SIZE_TYPE size_t
 #endif // JP_ALLOC_SIZE_TYPE
 
+// strtod rounds the few numbers the fast paths can't, in the decimal point
+// of the current locale
+#include <locale.h>
+#include <stdlib.h>
+
 #endif // NOSTDLIB
 
+#ifndef JP_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JP_SSE2
+#endif // __SSE2__
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JP_AVX2
+#endif // __AVX2__
+#endif // JP_NO_SIMD
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif // _MSC_VER
+
+// json_parallel runs its tasks one after another without them
+#if !defined(NOSTDLIB) && !defined(JP_NO_THREADS)
+#define JP_THREADS
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // _WIN32
+#endif // JP_NO_THREADS
+
+// json_map_file fails without them
+#if !defined(NOSTDLIB) && !defined(JP_NO_MMAP)
+#define JP_MMAP
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+#endif // JP_NO_MMAP
+
+#if defined(__UINTPTR_TYPE__)
+#define JP_UINTPTR __UINTPTR_TYPE__
+#else
+#include <stdint.h>
+#define JP_UINTPTR uintptr_t
+#endif // __UINTPTR_TYPE__
+
+// aligned SIMD loads may read past the terminator, but never past the page
+// it lives in
+#if defined(__SANITIZE_ADDRESS__)
+#define JP_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define JP_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif // address_sanitizer
+#endif // __SANITIZE_ADDRESS__
+#ifndef JP_NO_SANITIZE_ADDRESS
+#define JP_NO_SANITIZE_ADDRESS
+#endif // JP_NO_SANITIZE_ADDRESS
+
+// first chunk of a JArena, the next ones double
+#ifndef JP_ARENA_CHUNK_SIZE
+#define JP_ARENA_CHUNK_SIZE 4096
+#endif // JP_ARENA_CHUNK_SIZE
+
+// the most a JArena keeps over a reset, 0 keeps the largest chunk
+#ifndef JP_ARENA_RETAIN_LIMIT
+#define JP_ARENA_RETAIN_LIMIT 0
+#endif // JP_ARENA_RETAIN_LIMIT
+
+#ifndef JP_SCRATCH_INITIAL_SIZE
+#define JP_SCRATCH_INITIAL_SIZE 128
+#endif // JP_SCRATCH_INITIAL_SIZE
+
+// bytes of lines a worker of json_parse_lines_parallel takes at a time when
+// the records are delivered in order
+#ifndef JP_LINES_CHUNK_SIZE
+#define JP_LINES_CHUNK_SIZE (1024 * 1024)
+#endif // JP_LINES_CHUNK_SIZE
+
+#ifndef JP_MAX_THREADS
+#define JP_MAX_THREADS 64
+#endif // JP_MAX_THREADS
+
 // TODO(#21): utf8
-// TODO(#22): hex
-// TODO(#23): escapes
 // TODO(#17): examples
 // TODO(#14): tests
 typedef struct JPair JPair;
 typedef struct JValue JValue;
+typedef struct JCursor JCursor;
+typedef struct JTapeValue JTapeValue;
+typedef struct JDocument JDocument;
 typedef unsigned long long int jsize_t;
 
+// length of an input that ends at its terminator
+#define JSON_NUL_TERMINATED ((jsize_t)-1)
+
 typedef enum
 {
     JSON_KEY_NOT_FOUND = 2,
@@ -36,6 +137,8 @@ typedef enum
     JSON_PARSE_ERROR,
     JSON_TYPE_ERROR,
     JSON_MEMORY_ERROR,
+    JSON_RANGE_ERROR,
+    JSON_FILE_ERROR,
 } JCode;
 
 typedef enum
@@ -47,38 +150,97 @@ typedef enum
     JSON_NUMBER,
     JSON_ARRAY,
     JSON_ERROR,
+    JSON_DOUBLE,
+    // integers above LLONG_MAX that fit unsigned long long
+    JSON_UNSIGNED,
+    // integers out of the range of both, `string` holds their text
+    JSON_BIGNUM,
+    // unconverted number, `string` points at its text in the input, see
+    // JSON_LAZY_NUMBERS
+    JSON_RAW_NUMBER,
 } JType;
 
+typedef enum
+{
+    // strings and keys without escapes point into the input instead of
+    // being copied, they are not terminated and live as long as the input
+    JSON_ZERO_COPY = 1 << 1,
+    // strings and keys are decoded and terminated inside the input, which
+    // has to be writable, see json_parse_insitu
+    JSON_INSITU = 1 << 2,
+    // numbers are only validated and left as JSON_RAW_NUMBER, json_as_int,
+    // json_as_uint and json_as_double convert them, the text lives as long
+    // as the input
+    JSON_LAZY_NUMBERS = 1 << 3,
+    // json_parse_lines_parallel calls back from the workers as records
+    // complete instead of in input order
+    JSON_LINES_UNORDERED = 1 << 4,
+} JFlag;
+
 typedef struct
 {
     char *base;
     void *(*alloc)(JP_ALLOC_SIZE_TYPE size);
 } JMemory;
 
+// header of a JArena chunk, its bytes follow it
+typedef struct JArenaChunk
+{
+    struct JArenaChunk *previous;
+    jsize_t capacity;
+} JArenaChunk;
+
+// bump allocator over chunks of a backing allocator, see json_arena_init
+typedef struct
+{
+    void *(*alloc)(JP_ALLOC_SIZE_TYPE size);
+    // chunks are only handed back with it
+    void (*free)(void *ptr);
+    // the newest chunk, allocations are carved from it
+    JArenaChunk *chunk;
+    jsize_t used;
+    jsize_t next_capacity;
+    // a chunk bigger than this is freed on reset, 0 keeps any
+    jsize_t retain_limit;
+} JArena;
+
+// JP_COMPACT packs the tree into 16-byte values and 28-byte pairs, strings
+// and containers are limited to 4G bytes or elements
+#if defined(JP_COMPACT)
+typedef unsigned int jlength_t;
+#pragma pack(push, 4)
+#else
+typedef jsize_t jlength_t;
+#endif // JP_COMPACT
+
 typedef struct
 {
     JPair *data;
-    jsize_t length;
+    jlength_t length;
 } JObject;
 
 typedef struct
 {
     char *data;
-    jsize_t length;
+    jlength_t length;
 } JString;
 
 typedef struct
 {
     JValue *data;
-    jsize_t length;
+    jlength_t length;
 } JArray;
 
 struct JValue
 {
+#if !defined(JP_COMPACT)
     JType type;
+#endif // JP_COMPACT
     union
     {
         long long number;
+        unsigned long long unsigned_number;
+        double real;
         int boolean;
         int null;
         JString string;
@@ -86,7 +248,12 @@ struct JValue
         JObject object;
         JArray array;
     };
+#if defined(JP_COMPACT)
+    // after the payload, which keeps the pointers aligned in arrays
+    JType type;
+#endif // JP_COMPACT
 #ifdef __cplusplus
+    // copies like json_get, json_get_ptr reaches the value in the tree
     JValue operator[](const char *key);
     JValue operator[](jsize_t idx);
     JValue operator[](int idx);
@@ -96,34 +263,432 @@ struct JValue
 struct JPair
 {
     char *key;
+    jlength_t key_length;
     JValue value;
 };
 
+#if defined(JP_COMPACT)
+#pragma pack(pop)
+#endif // JP_COMPACT
+
+// a number split into its first 19 significant digits and a decimal
+// exponent, see json_scan_number
+typedef struct
+{
+    unsigned long long mantissa;
+    long long exponent;
+    int negative;
+    // no fraction and no exponent
+    int integer;
+    // some of the digits after the first 19 were not zero, integers that
+    // fit unsigned long long are never truncated
+    int truncated;
+} JNumber;
+
 typedef struct
 {
     JMemory *memory;
     const char *input;
+    jsize_t length;
     jsize_t pos;
-    jsize_t pairs_commited;
+    int flags;
+    // values and pairs of the containers that are still open, committed to
+    // memory once the container is closed
+    char *scratch;
+    jsize_t scratch_size;
+    jsize_t scratch_capacity;
+    // when set, the tree, the scratch and the index come from it instead of
+    // memory, see json_parse_arena
+    JArena *arena;
 } JParser;
 
+// gets every record of json_parse_lines, or the error that stopped it, the
+// value lives until the callback returns
+typedef void (*JLineCallback)(void *user, jsize_t line, JValue value);
+
+// events of json_sax_parse, callbacks left null are skipped, strings and keys
+// are not terminated and live until the callback returns
+typedef struct
+{
+    void (*on_object_begin)(void *user);
+    void (*on_object_end)(void *user);
+    void (*on_key)(void *user, const char *key, jsize_t length);
+    void (*on_string)(void *user, const char *string, jsize_t length);
+    // any of the number types, JSON_RAW_NUMBER with JSON_LAZY_NUMBERS
+    void (*on_number)(void *user, JValue number);
+    void (*on_bool)(void *user, int value);
+    void (*on_null)(void *user);
+    void (*on_array_begin)(void *user);
+    void (*on_array_end)(void *user);
+} JHandler;
+
+typedef struct
+{
+    jsize_t line;
+    JValue value;
+} JLineRecord;
+
+// a range of lines and the arena it is parsed into, see
+// json_parse_lines_parallel
+typedef struct
+{
+    JParser parser;
+    // the arena of every worker but the first, which uses the caller's
+    JArena arena;
+    const char *input;
+    jsize_t length;
+    // the line before the range, then the last line of it
+    jsize_t line;
+    jsize_t errors;
+    // set: records go straight to it, unset: they are kept in `records`
+    JLineCallback callback;
+    void *user;
+    JLineRecord *records;
+    jsize_t records_count;
+    jsize_t records_capacity;
+    // records there was no memory to keep
+    jsize_t dropped;
+} JLinesWorker;
+
+// a document parsed into one block of 64-bit words, see json_parse_tape
+typedef struct
+{
+    unsigned long long *words;
+    jsize_t length;
+    // decoded strings and number texts, each one terminated
+    char *strings;
+    // holds the block until json_tape_free
+    JArena arena;
+} JTape;
+
+// builds a JTape from the events of json_sax_parse
+typedef struct
+{
+    JTape *tape;
+    // word of the innermost open container
+    jsize_t open;
+    jsize_t strings_size;
+} JTapeBuilder;
+
+// a file mapped into memory, see json_map_file
+typedef struct
+{
+    const char *data;
+    jsize_t size;
+#if defined(_WIN32)
+    void *mapping;
+#endif // _WIN32
+} JFile;
+
+// owns everything a parse allocated, see json_parse_document
+struct JDocument
+{
+    JValue root;
+    JArena arena;
+    // mapped by json_parse_document_file, empty otherwise
+    JFile file;
+};
+
+#ifdef __cplusplus
+// move-only owner of a JDocument, json_free runs when it goes out of scope
+struct JScopedDocument
+{
+    JDocument document;
+    JScopedDocument();
+    explicit JScopedDocument(JDocument document);
+    JScopedDocument(JScopedDocument &&other) noexcept;
+    JScopedDocument &operator=(JScopedDocument &&other) noexcept;
+    JScopedDocument(const JScopedDocument &) = delete;
+    JScopedDocument &operator=(const JScopedDocument &) = delete;
+    ~JScopedDocument() noexcept;
+    JDocument *operator->();
+};
+#endif // __cplusplus
+
+// documents that follow each other in one buffer, see json_parse_many
+typedef struct
+{
+    JParser parser;
+    const char *input;
+    jsize_t length;
+    // where the next document is looked for
+    jsize_t offset;
+    // 1, or the JCode of the document that stopped the walk
+    int error;
+} JMany;
+
+// a range of the elements of the root array, see json_parse_parallel
+typedef struct
+{
+    JParser parser;
+    // what the elements are parsed into, handed to the caller's arena
+    JArena arena;
+    // the '[', ',' and ']' around every element
+    const jsize_t *separators;
+    JValue *values;
+    jsize_t first;
+    jsize_t last;
+    // 1, or the JCode of the first element that failed
+    int error;
+} JArrayWorker;
+
+// a value in the input that is only parsed when it is read, see
+// json_cursor_begin
+struct JCursor
+{
+    // escaped strings and values read with the cursor
+    JArena *arena;
+    const char *input;
+    jsize_t length;
+    // first byte of the value
+    jsize_t pos;
+    // containers: the value of the last element or pair returned, 0 before
+    // the first one and JSON_NUL_TERMINATED after the last one
+    jsize_t last;
+    // 1, or the JCode that stopped the walk
+    int error;
+#ifdef __cplusplus
+    JCursor operator[](const char *key);
+    JCursor operator[](jsize_t idx);
+    JCursor operator[](int idx);
+#endif // __cplusplus
+};
+
+// a value on a tape, see json_tape_root
+struct JTapeValue
+{
+    const JTape *tape;
+    // word of the value
+    jsize_t index;
+    // containers: the word of the last element or pair value returned, 0
+    // before the first one
+    jsize_t last;
+    // 1, or the JCode that produced this value
+    int error;
+#ifdef __cplusplus
+    JTapeValue operator[](const char *key);
+    JTapeValue operator[](jsize_t idx);
+    JTapeValue operator[](int idx);
+#endif // __cplusplus
+};
+
+typedef enum
+{
+    // the root, or a value after ':' or ','
+    JSON_STREAM_VALUE = 0,
+    // a value or ']' after '['
+    JSON_STREAM_ARRAY_START,
+    // a key or '}' after '{'
+    JSON_STREAM_OBJECT_START,
+    // a key after ','
+    JSON_STREAM_KEY,
+    JSON_STREAM_COLON,
+    // ',' or the closing bracket after a value
+    JSON_STREAM_NEXT,
+    // inside a string or key that did not end in its chunk, what was fed of
+    // it so far is in `token`
+    JSON_STREAM_STRING,
+    JSON_STREAM_KEY_STRING,
+    // inside a number or literal that reached the end of its chunk
+    JSON_STREAM_SCALAR,
+    // after the root, only whitespaces are left
+    JSON_STREAM_DONE,
+} JStreamState;
+
+typedef struct
+{
+    // '}' or ']'
+    char close;
+    // where the pairs or values of the container start in the scratch
+    jsize_t scratch_start;
+} JStreamFrame;
+
+// a parser that is fed the input in chunks, see json_stream_init
+typedef struct
+{
+    // parses every token out of its chunk or `token`, its scratch holds the
+    // values and pairs of the open containers
+    JParser parser;
+    JStreamState state;
+    // 1, or the JCode that stopped the stream
+    int error;
+    // the partial string ends in an unpaired backslash
+    int escaped;
+    // bytes fed before the current chunk
+    jsize_t offset;
+    JStreamFrame *frames;
+    jsize_t depth;
+    jsize_t frames_capacity;
+    char *token;
+    jsize_t token_length;
+    jsize_t token_capacity;
+    JValue root;
+} JStreamParser;
+
 int json_whitespace_char(char c);
 int json_match_char(JParser *parser, char c);
+char json_peek(JParser *parser);
 int json_skip_whitespaces(JParser *parser);
+jsize_t json_skip_whitespace_run(const char *input, jsize_t pos, jsize_t length);
+unsigned long long json_load64(const void *src);
+int json_ctz(unsigned long long mask);
+int json_clz(unsigned long long mask);
+unsigned long long json_mul128(unsigned long long a, unsigned long long b, unsigned long long *high);
 int json_memcmp(const void *str1, const void *str2, jsize_t count);
 int json_strcmp(const char *p1, const char *p2);
 void *json_memcpy(void *dst, void const *src, jsize_t size);
+jsize_t json_scan_string(const char *input, jsize_t pos, jsize_t length);
+int json_hex4(const char *src, unsigned int *code_point);
+jsize_t json_utf8_encode(char *dst, unsigned int code_point);
+int json_unescape(char *dst, const char *src, jsize_t length, jsize_t *dst_length);
+void *json_scratch_push(JParser *parser, jsize_t size);
+void *json_alloc(JParser *parser, jsize_t size);
+void json_reset_parser(JParser *parser);
+jsize_t json_find_newline(const char *input, jsize_t pos, jsize_t length);
+jsize_t json_count_newlines(const char *input, jsize_t length);
+int json_can_load64(const char *input, jsize_t pos, jsize_t length);
+int json_is_eight_digits(unsigned long long chunk);
+unsigned long long json_parse_eight_digits(unsigned long long chunk);
+int json_scan_number(const char *input, jsize_t pos, jsize_t length, JNumber *number, jsize_t *end);
+jsize_t json_skip_digits(const char *input, jsize_t pos, jsize_t length);
+int json_validate_number(const char *input, jsize_t pos, jsize_t length, jsize_t *end);
+unsigned long long json_eisel_lemire(unsigned long long mantissa, long long exponent);
+double json_number_to_double(const JNumber *number, const char *source, jsize_t length);
+JValue json_number_value(const JNumber *number, const char *source, jsize_t length);
+int json_convert_number(JValue *value);
+int json_as_int(JValue *value, long long *result);
+int json_as_uint(JValue *value, unsigned long long *result);
+int json_as_double(JValue *value, double *result);
 JValue json_get(JObject *object, const char *key);
+JValue *json_get_ptr(JObject *object, const char *key);
+int json_get_int(JObject *object, const char *key, long long *result);
+int json_get_uint(JObject *object, const char *key, unsigned long long *result);
+int json_get_double(JObject *object, const char *key, double *result);
+JArena json_arena_init(void);
+JArena json_arena_init_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr));
+void *json_arena_alloc(JArena *arena, jsize_t size, jsize_t align);
+void json_arena_reset(JArena *arena);
+void json_arena_free(JArena *arena);
+jsize_t json_arena_capacity(const JArena *arena);
+jsize_t json_arena_size(const JArena *arena);
+int json_arena_reserve(JArena *arena, jsize_t capacity);
+void json_arena_adopt(JArena *arena, JArena *other);
+JValue json_parse_arena(JArena *arena, const char *input, jsize_t length, int flags);
 JValue json_parse(const char *input);
+JValue json_parse_view(const char *input);
 JValue json_parse_custom(JMemory *memory, const char *input);
+JValue json_parse_flags(JMemory *memory, const char *input, int flags);
+JValue json_parse_n(const char *input, jsize_t length);
+JValue json_parse_custom_n(JMemory *memory, const char *input, jsize_t length, int flags);
+JValue json_parse_insitu(char *input, jsize_t length);
+int json_map_file(const char *path, int flags, JFile *file);
+void json_unmap_file(JFile *file);
+JValue json_parse_file(JArena *arena, const char *path, JFile *file);
+JValue json_file_error(const char *path, int error);
+JValue json_parse_file_custom(JMemory *memory, const char *path, int flags, JFile *file);
+JDocument json_init_document(JArena arena);
+JDocument json_parse_document(const char *input, jsize_t length, int flags);
+JDocument json_parse_document_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr), const char *input, jsize_t length, int flags);
+JDocument json_parse_document_file(const char *path, int flags);
+void json_free(JDocument *document);
+JValue json_parse_reuse(JDocument *document, const char *input, jsize_t length, int flags);
+jsize_t json_parse_lines(const char *input, jsize_t length, JLineCallback callback, void *user);
+jsize_t json_parse_lines_custom(JArena *arena, const char *input, jsize_t length, int flags, JLineCallback callback, void *user);
+JValue json_parse_line(JParser *parser);
+JMany json_parse_many(JArena *arena, const char *input, jsize_t length, int flags);
+int json_many_next(JMany *many, JValue *document, jsize_t *end);
+jsize_t json_parse_line_range(JParser *parser, const char *input, jsize_t length, jsize_t *line, int keep,
+                              JLineCallback callback, void *user);
+void json_parallel(void (*task)(void *arg), void *args, jsize_t arg_size, int count);
+void json_lines_keep(void *user, jsize_t line, JValue value);
+void json_lines_count(void *arg);
+void json_lines_work(void *arg);
+jsize_t json_parse_lines_parallel(JArena *arena, const char *input, jsize_t length, int flags, int threads,
+                                  JLineCallback callback, void *user);
+JValue json_parse_root(JParser *parser);
 JValue json_parse_object(JParser *parser);
 JValue json_parse_value(JParser *parser);
 JValue json_parse_string(JParser *parser);
-JValue json_parse_number(JParser *parser, int negative);
+JValue json_parse_number(JParser *parser);
 JValue json_parse_boolean(JParser *parser, int bool_value, const char *bool_string, jsize_t bool_string_length);
 JValue json_parse_null(JParser *parser);
 JValue json_parse_array(JParser *parser);
 JValue json_unexpected_eof(jsize_t pos);
+int json_length_fits(jsize_t length);
+JValue json_too_long(jsize_t pos);
+int json_skip_string(JParser *parser);
+int json_popcount(unsigned long long mask);
+int json_skip_container(JParser *parser);
+int json_skip_value(JParser *parser);
+JCursor json_cursor_begin(JArena *arena, const char *input, jsize_t length);
+JCursor json_cursor_error(JCode error);
+JParser json_cursor_parser(JCursor *cursor, jsize_t pos);
+JType json_cursor_type(JCursor *cursor);
+int json_cursor_next(JCursor *container, char close, JCursor *value);
+int json_cursor_next_field(JCursor *object, JString *key, JCursor *value);
+int json_cursor_next_element(JCursor *array, JCursor *element);
+int json_cursor_key_equals(JString raw, const char *key);
+JCursor json_cursor_find_field(JCursor *object, const char *key);
+JCursor json_cursor_at(JCursor *array, jsize_t idx);
+int json_cursor_number(JCursor *cursor, JValue *value);
+int json_cursor_get_int(JCursor *cursor, long long *result);
+int json_cursor_get_uint(JCursor *cursor, unsigned long long *result);
+int json_cursor_get_double(JCursor *cursor, double *result);
+int json_cursor_get_bool(JCursor *cursor, int *result);
+int json_cursor_get_string(JCursor *cursor, JString *result);
+JValue json_cursor_get_value(JCursor *cursor);
+JStreamParser json_stream_init(JArena *arena);
+int json_stream_feed(JStreamParser *stream, const char *chunk, jsize_t length);
+JValue json_stream_finish(JStreamParser *stream);
+void *json_stream_grow(JStreamParser *stream, void *data, jsize_t used, jsize_t *capacity, jsize_t needed);
+int json_stream_append(JStreamParser *stream, const char *src, jsize_t size);
+int json_stream_add(JStreamParser *stream, JValue value);
+int json_stream_open(JStreamParser *stream, char c);
+int json_stream_close(JStreamParser *stream);
+int json_stream_value(JStreamParser *stream, JValue value, int key);
+int json_stream_token(JStreamParser *stream, int key);
+jsize_t json_stream_string_end(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length);
+int json_scalar_char(char c);
+jsize_t json_stream_string(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length, int key);
+jsize_t json_stream_scalar(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length);
+jsize_t json_stream_step(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length);
+int json_index_elements(JParser *parser, jsize_t *count);
+void json_array_work(void *arg);
+JValue json_parse_parallel(JArena *arena, const char *input, jsize_t length, int flags, int threads);
+int json_sax_parse(const char *input, jsize_t length, const JHandler *handler, void *user);
+int json_sax_parse_custom(JArena *arena, const char *input, jsize_t length, int flags, const JHandler *handler,
+                          void *user);
+int json_sax_value(JParser *parser, const JHandler *handler, void *user);
+int json_sax_object(JParser *parser, const JHandler *handler, void *user);
+int json_sax_array(JParser *parser, const JHandler *handler, void *user);
+int json_sax_string(JParser *parser, JString *string);
+int json_parse_tape(const char *input, jsize_t length, JTape *tape);
+int json_parse_tape_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr), const char *input,
+                           jsize_t length, int flags, JTape *tape);
+void json_tape_free(JTape *tape);
+void json_tape_open(void *user, char tag);
+void json_tape_close(void *user, char tag);
+void json_tape_object_begin(void *user);
+void json_tape_object_end(void *user);
+void json_tape_array_begin(void *user);
+void json_tape_array_end(void *user);
+void json_tape_string(void *user, const char *string, jsize_t length);
+void json_tape_text(JTapeBuilder *builder, char tag, const char *text, jsize_t length);
+void json_tape_number(void *user, JValue number);
+void json_tape_bool(void *user, int value);
+void json_tape_null(void *user);
+void json_measure_tape(const char *input, jsize_t length, jsize_t *words, jsize_t *strings);
+char json_tape_tag(const JTape *tape, jsize_t index);
+jsize_t json_tape_payload(const JTape *tape, jsize_t index);
+jsize_t json_tape_skip(const JTape *tape, jsize_t index);
+JTapeValue json_tape_root(const JTape *tape);
+JTapeValue json_tape_error(JCode error);
+JType json_tape_type(JTapeValue *value);
+int json_tape_next_element(JTapeValue *array, JTapeValue *element);
+int json_tape_next_field(JTapeValue *object, JString *key, JTapeValue *value);
+JTapeValue json_tape_get(JTapeValue *object, const char *key);
+JTapeValue json_tape_at(JTapeValue *array, jsize_t idx);
+JValue json_tape_value(JTapeValue *value);
 
 #endif // JP_H_
 
@@ -162,6 +727,58 @@ JValue JValue::operator[](int idx)
 {
     return operator[](static_cast<jsize_t>(idx));
 }
+JCursor JCursor::operator[](const char *key)
+{
+    return json_cursor_find_field(this, key);
+}
+JCursor JCursor::operator[](jsize_t idx)
+{
+    return json_cursor_at(this, idx);
+}
+JCursor JCursor::operator[](int idx)
+{
+    return operator[](static_cast<jsize_t>(idx));
+}
+JTapeValue JTapeValue::operator[](const char *key)
+{
+    return json_tape_get(this, key);
+}
+JTapeValue JTapeValue::operator[](jsize_t idx)
+{
+    return json_tape_at(this, idx);
+}
+JTapeValue JTapeValue::operator[](int idx)
+{
+    return operator[](static_cast<jsize_t>(idx));
+}
+JScopedDocument::JScopedDocument() : document(json_init_document(json_arena_init()))
+{
+}
+JScopedDocument::JScopedDocument(JDocument document) : document(document)
+{
+}
+JScopedDocument::JScopedDocument(JScopedDocument &&other) noexcept : document(other.document)
+{
+    other.document = json_init_document(json_arena_init_custom(document.arena.alloc, document.arena.free));
+}
+// the other document is left empty
+JScopedDocument &JScopedDocument::operator=(JScopedDocument &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+    json_free(&document);
+    document = other.document;
+    other.document = json_init_document(json_arena_init_custom(document.arena.alloc, document.arena.free));
+    return *this;
+}
+JScopedDocument::~JScopedDocument() noexcept
+{
+    json_free(&document);
+}
+JDocument *JScopedDocument::operator->()
+{
+    return &document;
+}
 #endif // __cplusplus
 
 int json_whitespace_char(char c)
@@ -171,25 +788,294 @@ int json_whitespace_char(char c)
 
 int json_match_char(JParser *parser, char c)
 {
-    do
-    {
-        if (parser->input[parser->pos] == '\0')
-            return JSON_UNEXPECTED_EOF;
-    } while (json_whitespace_char(parser->input[parser->pos++]));
-    if (parser->input[parser->pos - 1] != c)
+    if (!json_skip_whitespaces(parser))
+        return JSON_UNEXPECTED_EOF;
+    if (parser->input[parser->pos++] != c)
         return JSON_PARSE_ERROR;
     return 1;
 }
 
+// the current byte, the end of the input reads as a terminator
+char json_peek(JParser *parser)
+{
+    return parser->pos < parser->length ? parser->input[parser->pos] : '\0';
+}
+
 int json_skip_whitespaces(JParser *parser)
 {
-    while (json_whitespace_char(parser->input[parser->pos]))
+    if (json_whitespace_char(json_peek(parser)))
+    {
         parser->pos++;
-    if (parser->input[parser->pos] == '\0')
+        // most runs are a single space after ':' or ','
+        if (json_whitespace_char(json_peek(parser)))
+            parser->pos = json_skip_whitespace_run(parser->input, parser->pos, parser->length);
+    }
+    if (json_peek(parser) == '\0')
         return 0;
     return 1;
 }
 
+JP_NO_SANITIZE_ADDRESS unsigned long long json_load64(const void *src)
+{
+    const unsigned char *bytes = (const unsigned char *)src;
+    return (unsigned long long)bytes[0] | (unsigned long long)bytes[1] << 8 |
+           (unsigned long long)bytes[2] << 16 | (unsigned long long)bytes[3] << 24 |
+           (unsigned long long)bytes[4] << 32 | (unsigned long long)bytes[5] << 40 |
+           (unsigned long long)bytes[6] << 48 | (unsigned long long)bytes[7] << 56;
+}
+
+// skips newline + indentation runs a block at a time, a block of spaces only
+// costs a single comparison
+JP_NO_SANITIZE_ADDRESS jsize_t json_skip_whitespace_run(const char *input, jsize_t pos, jsize_t length)
+{
+#if defined(JP_SSE2)
+    const char *block = (const char *)((JP_UINTPTR)(input + pos) & ~(JP_UINTPTR)15);
+    unsigned int skip = (unsigned int)(input + pos - block);
+    const __m128i spaces = _mm_set1_epi8(' ');
+    for (;; block += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)block);
+        unsigned int space_mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, spaces));
+        if ((space_mask | ((1u << skip) - 1)) == 0xFFFF)
+        {
+            if ((jsize_t)(block + 16 - input) >= length)
+                return length;
+            skip = 0;
+            continue;
+        }
+        unsigned int whitespace_mask = space_mask |
+            (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))) |
+            (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))) |
+            (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')));
+        unsigned int other_mask = ~whitespace_mask & 0xFFFF & ~((1u << skip) - 1);
+        if (other_mask)
+            pos = (jsize_t)(block + json_ctz(other_mask) - input);
+        else if ((jsize_t)(block + 16 - input) >= length)
+            pos = length;
+        else
+        {
+            skip = 0;
+            continue;
+        }
+        return pos < length ? pos : length;
+    }
+#else
+    while (pos < length && ((JP_UINTPTR)(input + pos) & 7) && json_whitespace_char(input[pos]))
+        pos++;
+    while (pos + 8 <= length && json_load64(input + pos) == 0x2020202020202020ULL)
+        pos += 8;
+    while (pos < length && json_whitespace_char(input[pos]))
+        pos++;
+    return pos;
+#endif // JP_SSE2
+}
+
+int json_ctz(unsigned long long mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int)index;
+#else
+    int count = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+int json_clz(unsigned long long mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(mask);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return 63 - (int)index;
+#else
+    int count = 0;
+    while (!(mask & (1ULL << 63)))
+    {
+        mask <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// low 64 bits of a * b, the high ones go to `high`
+unsigned long long json_mul128(unsigned long long a, unsigned long long b, unsigned long long *high)
+{
+#if defined(__SIZEOF_INT128__) && !defined(__wasm__)
+    __extension__ unsigned __int128 product = (unsigned __int128)a * b;
+    *high = (unsigned long long)(product >> 64);
+    return (unsigned long long)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, high);
+#else
+    unsigned long long a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+    unsigned long long b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+    unsigned long long low_low = a_low * b_low;
+    unsigned long long high_low = a_high * b_low;
+    unsigned long long cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + a_low * b_high;
+    *high = (high_low >> 32) + (cross >> 32) + a_high * b_high;
+    return (cross << 32) | (low_low & 0xFFFFFFFF);
+#endif
+}
+
+#define JSON_BLOCK_SIZE 64
+
+typedef struct
+{
+    unsigned long long quote;
+    unsigned long long backslash;
+    unsigned long long op;
+    // the brackets among op
+    unsigned long long bracket;
+    unsigned long long whitespace;
+    unsigned long long zero;
+} JBlock;
+
+typedef struct
+{
+    unsigned long long quote;
+    unsigned long long backslash;
+    unsigned long long open;
+    unsigned long long close;
+    unsigned long long zero;
+} JBrackets;
+
+typedef struct
+{
+    unsigned long long prev_escaped;
+    unsigned long long prev_in_string;
+    unsigned long long prev_scalar;
+} JIndexState;
+
+#if defined(JP_AVX2)
+unsigned long long json_avx2_eq(__m256i chunk, char c)
+{
+    return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c)));
+}
+#elif defined(JP_SSE2)
+unsigned long long json_sse2_eq(__m128i chunk, char c)
+{
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)));
+}
+#endif // JP_AVX2
+
+// the SIMD versions read the whole aligned block, which never crosses a page
+// boundary, the scalar version stops at the terminator or after `available`
+// bytes
+JP_NO_SANITIZE_ADDRESS void json_classify_block(const unsigned char *block, jsize_t available, JBlock *masks)
+{
+#if defined(JP_AVX2)
+    masks->quote = masks->backslash = masks->op = masks->bracket = masks->whitespace = masks->zero = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 32)
+    {
+        __m256i chunk = _mm256_load_si256((const __m256i *)(block + i));
+        unsigned long long bracket = json_avx2_eq(chunk, '{') | json_avx2_eq(chunk, '}') |
+                                     json_avx2_eq(chunk, '[') | json_avx2_eq(chunk, ']');
+        masks->quote |= json_avx2_eq(chunk, '"') << i;
+        masks->backslash |= json_avx2_eq(chunk, '\\') << i;
+        masks->bracket |= bracket << i;
+        masks->op |= (bracket | json_avx2_eq(chunk, ':') | json_avx2_eq(chunk, ',')) << i;
+        masks->whitespace |= (json_avx2_eq(chunk, ' ') | json_avx2_eq(chunk, '\t') |
+                              json_avx2_eq(chunk, '\n') | json_avx2_eq(chunk, '\r')) << i;
+        masks->zero |= json_avx2_eq(chunk, '\0') << i;
+    }
+#elif defined(JP_SSE2)
+    masks->quote = masks->backslash = masks->op = masks->bracket = masks->whitespace = masks->zero = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)(block + i));
+        unsigned long long bracket = json_sse2_eq(chunk, '{') | json_sse2_eq(chunk, '}') |
+                                     json_sse2_eq(chunk, '[') | json_sse2_eq(chunk, ']');
+        masks->quote |= json_sse2_eq(chunk, '"') << i;
+        masks->backslash |= json_sse2_eq(chunk, '\\') << i;
+        masks->bracket |= bracket << i;
+        masks->op |= (bracket | json_sse2_eq(chunk, ':') | json_sse2_eq(chunk, ',')) << i;
+        masks->whitespace |= (json_sse2_eq(chunk, ' ') | json_sse2_eq(chunk, '\t') |
+                              json_sse2_eq(chunk, '\n') | json_sse2_eq(chunk, '\r')) << i;
+        masks->zero |= json_sse2_eq(chunk, '\0') << i;
+    }
+#else
+    masks->quote = masks->backslash = masks->op = masks->bracket = masks->whitespace = masks->zero = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE && (jsize_t)i < available; ++i)
+    {
+        unsigned long long bit = 1ULL << i;
+        switch (block[i])
+        {
+        case '"':
+            masks->quote |= bit;
+            break;
+        case '\\':
+            masks->backslash |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+            masks->bracket |= bit;
+            masks->op |= bit;
+            break;
+        case ':':
+        case ',':
+            masks->op |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            masks->whitespace |= bit;
+            break;
+        case '\0':
+            masks->zero |= bit;
+            return;
+        }
+    }
+#endif // JP_AVX2
+    (void)available;
+}
+
+// characters escaped by an odd-length run of backslashes, the carry tells
+// whether the previous block ended in such a run
+unsigned long long json_escaped_mask(unsigned long long backslash, unsigned long long *prev_escaped)
+{
+    const unsigned long long even_bits = 0x5555555555555555ULL;
+    const unsigned long long odd_bits = ~even_bits;
+    unsigned long long start_edges = backslash & ~(backslash << 1);
+    unsigned long long even_start_mask = even_bits ^ *prev_escaped;
+    unsigned long long even_starts = start_edges & even_start_mask;
+    unsigned long long odd_starts = start_edges & ~even_start_mask;
+    unsigned long long even_carries = backslash + even_starts;
+    unsigned long long odd_carries = backslash + odd_starts;
+    int ends_odd_backslash = odd_carries < backslash;
+    odd_carries |= *prev_escaped;
+    *prev_escaped = ends_odd_backslash ? 1ULL : 0ULL;
+    unsigned long long even_carry_ends = even_carries & ~backslash;
+    unsigned long long odd_carry_ends = odd_carries & ~backslash;
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+// every bit is the xor of itself and the bits below, opening quotes up to
+// the byte before their closing quote
+unsigned long long json_prefix_xor(unsigned long long mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
 int json_memcmp(const void *str1, const void *str2, jsize_t count)
 {
     const unsigned char *s1 = (const unsigned char *)str1;
@@ -217,411 +1103,4265 @@ int json_strcmp(const char *p1, const char *p2)
     return c1 - c2;
 }
 
+// copies forward, so dst may overlap src as long as it is not after it
 void *json_memcpy(void *dst, void const *src, jsize_t size)
 {
     unsigned char *source = (unsigned char *)src;
     unsigned char *dest = (unsigned char *)dst;
+#if defined(JP_SSE2)
+    for (; size >= 16; size -= 16, source += 16, dest += 16)
+        _mm_storeu_si128((__m128i *)dest, _mm_loadu_si128((const __m128i *)source));
+#endif // JP_SSE2
     while (size--)
         *dest++ = *source++;
     return dst;
 }
 
-JParser json_init_parser(JMemory *memory, const char *input)
+// position of the first '"', '\\' or control character at or after pos, the
+// terminator included, or `length` when there is none before it
+JP_NO_SANITIZE_ADDRESS jsize_t json_scan_string(const char *input, jsize_t pos, jsize_t length)
 {
-    JParser parser;
-    parser.memory = memory;
-    parser.input = input;
-    parser.pos = 0;
-    parser.pairs_commited = 0;
-    jsize_t pairs_total = 0;
-    for (jsize_t i = 0; input[i] != 0; ++i)
-        if (input[i] == ':' && input[i - 1] == '"' && input[i - 2] != '\\')
-            pairs_total++;
-    parser.memory->base = (char *)parser.memory->alloc(sizeof(JPair) * pairs_total);
-    return parser;
+    if (pos >= length)
+        return length;
+#if defined(JP_SSE2)
+    const char *block = (const char *)((JP_UINTPTR)(input + pos) & ~(JP_UINTPTR)15);
+    unsigned int skip_mask = (1u << (input + pos - block)) - 1;
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (;; block += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)block);
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(special) & ~skip_mask;
+        if (mask)
+            pos = (jsize_t)(block + json_ctz(mask) - input);
+        else if ((jsize_t)(block + 16 - input) >= length)
+            pos = length;
+        else
+        {
+            skip_mask = 0;
+            continue;
+        }
+        return pos < length ? pos : length;
+    }
+#else
+    for (; pos < length && ((JP_UINTPTR)(input + pos) & 7); ++pos)
+    {
+        unsigned char c = (unsigned char)input[pos];
+        if (c == '"' || c == '\\' || c < 0x20)
+            return pos;
+    }
+    const unsigned long long ones = 0x0101010101010101ULL;
+    const unsigned long long highs = 0x8080808080808080ULL;
+    for (; pos + 8 <= length; pos += 8)
+    {
+        unsigned long long word = json_load64(input + pos);
+        unsigned long long quote = word ^ (ones * '"');
+        unsigned long long backslash = word ^ (ones * '\\');
+        unsigned long long special = ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) |
+                                     ((word - ones * 0x20) & ~word);
+        special &= highs;
+        if (special)
+            return pos + (jsize_t)(json_ctz(special) >> 3);
+    }
+    for (; pos < length; ++pos)
+    {
+        unsigned char c = (unsigned char)input[pos];
+        if (c == '"' || c == '\\' || c < 0x20)
+            return pos;
+    }
+    return length;
+#endif // JP_SSE2
 }
 
-JValue json_parse(const char *input)
+// position of the first '\n' at or after pos, or `length` when there is none
+JP_NO_SANITIZE_ADDRESS jsize_t json_find_newline(const char *input, jsize_t pos, jsize_t length)
 {
-    JMemory memory;
-    memory.alloc = JP_DEFAULT_ALLOC;
-    return json_parse_custom(&memory, input);
+    if (pos >= length)
+        return length;
+#if defined(JP_SSE2)
+    const char *block = (const char *)((JP_UINTPTR)(input + pos) & ~(JP_UINTPTR)15);
+    unsigned int skip_mask = (1u << (input + pos - block)) - 1;
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (;; block += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)block);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)) & ~skip_mask;
+        if (mask)
+            pos = (jsize_t)(block + json_ctz(mask) - input);
+        else if ((jsize_t)(block + 16 - input) >= length)
+            pos = length;
+        else
+        {
+            skip_mask = 0;
+            continue;
+        }
+        return pos < length ? pos : length;
+    }
+#else
+    for (; pos < length && ((JP_UINTPTR)(input + pos) & 7); ++pos)
+    {
+        if (input[pos] == '\n')
+            return pos;
+    }
+    const unsigned long long ones = 0x0101010101010101ULL;
+    const unsigned long long highs = 0x8080808080808080ULL;
+    for (; pos + 8 <= length; pos += 8)
+    {
+        unsigned long long word = json_load64(input + pos) ^ (ones * '\n');
+        unsigned long long newline = (word - ones) & ~word & highs;
+        if (newline)
+            return pos + (jsize_t)(json_ctz(newline) >> 3);
+    }
+    for (; pos < length; ++pos)
+    {
+        if (input[pos] == '\n')
+            return pos;
+    }
+    return length;
+#endif // JP_SSE2
 }
 
-JValue json_parse_custom(JMemory *memory, const char *input)
+jsize_t json_count_newlines(const char *input, jsize_t length)
 {
-    JParser parser = json_init_parser(memory, input);
-    json_skip_whitespaces(&parser);
-    return json_parse_value(&parser);
+    jsize_t count = 0;
+    jsize_t pos = 0;
+#if defined(JP_SSE2)
+    for (; pos < length && ((JP_UINTPTR)(input + pos) & 15); ++pos)
+        count += input[pos] == '\n';
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; pos + 16 <= length; pos += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)(input + pos));
+        count += (jsize_t)json_popcount((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+    }
+#else
+    // exact per byte, a borrow out of a matching byte can't fake the next one
+    const unsigned long long lows = 0x7F7F7F7F7F7F7F7FULL;
+    for (; pos + 8 <= length; pos += 8)
+    {
+        unsigned long long word = json_load64(input + pos) ^ 0x0A0A0A0A0A0A0A0AULL;
+        count += (jsize_t)json_popcount(~(((word & lows) + lows) | word) & ~lows);
+    }
+#endif // JP_SSE2
+    for (; pos < length; ++pos)
+        count += input[pos] == '\n';
+    return count;
 }
 
-JValue json_get(JObject *object, const char *key)
+int json_hex4(const char *src, unsigned int *code_point)
 {
-    for (jsize_t i = 0; i < object->length; ++i)
-        if (json_strcmp(key, object->data[i].key) == 0)
-            return object->data[i].value;
-    JValue value;
-    value.type = JSON_ERROR;
-    value.error = JSON_KEY_NOT_FOUND;
-#if !defined(NDEBUG)
-    fprintf(stderr, "key \"%s\" was not found\n", key);
-#endif // NDEBUG
-    return value;
+    *code_point = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = src[i];
+        unsigned int digit;
+        if (c >= '0' && c <= '9')
+            digit = (unsigned int)(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            digit = (unsigned int)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            digit = (unsigned int)(c - 'A' + 10);
+        else
+            return JSON_PARSE_ERROR;
+        *code_point = *code_point << 4 | digit;
+    }
+    return 1;
 }
 
-JValue json_parse_string(JParser *parser)
+jsize_t json_utf8_encode(char *dst, unsigned int code_point)
 {
-    parser->pos++;
-    jsize_t start = parser->pos;
-    while (parser->input[parser->pos] != '"' && parser->input[parser->pos - 1] != '\\')
+    if (code_point < 0x80)
     {
-        if (parser->input[parser->pos] == '\0')
-            return json_unexpected_eof(parser->pos);
-        parser->pos++;
+        dst[0] = (char)code_point;
+        return 1;
     }
-    char *value_string = 0;
-    jsize_t string_size = 1;
-    if (parser->pos - start != 0)
+    if (code_point < 0x800)
     {
-        string_size = parser->pos - start + 1;
-        value_string = (char *)parser->memory->alloc(string_size);
-        if (value_string == 0)
-        {
-            JValue value;
-            value.type = JSON_ERROR;
-            value.error = JSON_MEMORY_ERROR;
-            return value;
-        }
-        json_memcpy(value_string, parser->input + start, string_size - 1);
-        value_string[string_size - 1] = '\0';
+        dst[0] = (char)(0xC0 | (code_point >> 6));
+        dst[1] = (char)(0x80 | (code_point & 0x3F));
+        return 2;
     }
-    JValue value;
-    value.type = JSON_STRING;
-    value.string.data = value_string;
-    value.string.length = string_size - 1;
-    parser->pos++;
-    return value;
+    if (code_point < 0x10000)
+    {
+        dst[0] = (char)(0xE0 | (code_point >> 12));
+        dst[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        dst[2] = (char)(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    dst[0] = (char)(0xF0 | (code_point >> 18));
+    dst[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+    dst[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+    dst[3] = (char)(0x80 | (code_point & 0x3F));
+    return 4;
 }
 
-JValue json_parse_number(JParser *parser, int negative)
+// decodes the `length` bytes of a string body that ends right before its
+// closing quote, dst may be src since the output is never longer
+int json_unescape(char *dst, const char *src, jsize_t length, jsize_t *dst_length)
 {
-    if (negative)
-        parser->pos++;
-    jsize_t start_pos = parser->pos;
-    while (!json_whitespace_char(parser->input[parser->pos]) &&
-           parser->input[parser->pos] != ',' && parser->input[parser->pos] != '}' &&
-           parser->input[parser->pos] != ']' && parser->input[parser->pos] != '\0')
+    jsize_t i = 0;
+    jsize_t written = 0;
+    while (i < length)
     {
-        parser->pos++;
+        jsize_t next = json_scan_string(src, i, length);
+        json_memcpy(dst + written, src + i, next - i);
+        written += next - i;
+        i = next;
+        if (i >= length)
+            break;
+        switch (src[i + 1])
+        {
+        case '"':  dst[written++] = '"';  break;
+        case '\\': dst[written++] = '\\'; break;
+        case '/':  dst[written++] = '/';  break;
+        case 'b':  dst[written++] = '\b'; break;
+        case 'f':  dst[written++] = '\f'; break;
+        case 'n':  dst[written++] = '\n'; break;
+        case 'r':  dst[written++] = '\r'; break;
+        case 't':  dst[written++] = '\t'; break;
+        case 'u':
+            {
+                unsigned int code_point;
+                if (i + 6 > length || json_hex4(src + i + 2, &code_point) != 1)
+                    return JSON_PARSE_ERROR;
+                if (code_point >= 0xDC00 && code_point <= 0xDFFF)
+                    return JSON_PARSE_ERROR;
+                if (code_point >= 0xD800 && code_point <= 0xDBFF)
+                {
+                    unsigned int low;
+                    if (i + 12 > length || src[i + 6] != '\\' || src[i + 7] != 'u' ||
+                        json_hex4(src + i + 8, &low) != 1 || low < 0xDC00 || low > 0xDFFF)
+                        return JSON_PARSE_ERROR;
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                written += json_utf8_encode(dst + written, code_point);
+                i += 4;
+            }
+            break;
+        default:
+            return JSON_PARSE_ERROR;
+        }
+        i += 2;
     }
-    jsize_t number_string_length = parser->pos - start_pos;
-    jsize_t number = 0;
-    jsize_t i = 0;
-    while (i < number_string_length)
+    *dst_length = written;
+    return 1;
+}
+
+JParser json_init_parser(JMemory *memory, const char *input)
+{
+    JParser parser;
+    parser.memory = memory;
+    parser.input = input;
+    parser.length = JSON_NUL_TERMINATED;
+    parser.pos = 0;
+    parser.flags = 0;
+    parser.scratch = 0;
+    parser.scratch_size = 0;
+    parser.scratch_capacity = 0;
+    parser.arena = 0;
+    return parser;
+}
+
+void *json_scratch_push(JParser *parser, jsize_t size)
+{
+    if (parser->scratch_size + size > parser->scratch_capacity)
+    {
+        jsize_t capacity = parser->scratch_capacity ? parser->scratch_capacity * 2 : JP_SCRATCH_INITIAL_SIZE;
+        while (capacity < parser->scratch_size + size)
+            capacity *= 2;
+        char *scratch = parser->arena ? (char *)json_arena_alloc(parser->arena, capacity, 8)
+                                      : (char *)parser->memory->alloc(capacity);
+        if (scratch == 0)
+            return 0;
+        json_memcpy(scratch, parser->scratch, parser->scratch_size);
+        parser->scratch = scratch;
+        parser->scratch_capacity = capacity;
+    }
+    parser->scratch_size += size;
+    return parser->scratch + parser->scratch_size - size;
+}
+
+// memory for the tree, 8-byte aligned in the arena
+void *json_alloc(JParser *parser, jsize_t size)
+{
+    return parser->arena ? json_arena_alloc(parser->arena, size, 8) : parser->memory->alloc(size);
+}
+
+// drops everything the parser carved from its arena, the scratch included
+void json_reset_parser(JParser *parser)
+{
+    json_arena_reset(parser->arena);
+    parser->scratch = 0;
+    parser->scratch_size = 0;
+    parser->scratch_capacity = 0;
+}
+
+JArena json_arena_init(void)
+{
+#if defined(JP_DEFAULT_FREE)
+    return json_arena_init_custom(JP_DEFAULT_ALLOC, JP_DEFAULT_FREE);
+#else
+    return json_arena_init_custom(JP_DEFAULT_ALLOC, 0);
+#endif // JP_DEFAULT_FREE
+}
+
+// nothing is allocated until the first json_arena_alloc
+JArena json_arena_init_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr))
+{
+    JArena arena;
+    arena.alloc = alloc;
+    arena.free = free;
+    arena.chunk = 0;
+    arena.used = 0;
+    arena.next_capacity = JP_ARENA_CHUNK_SIZE;
+    arena.retain_limit = JP_ARENA_RETAIN_LIMIT;
+    return arena;
+}
+
+// `align` is a power of two, a request that doesn't fit the chunk starts a
+// new one at least twice as big, or just as big as the request when that is
+// bigger still, the rest of the old one is left unused
+void *json_arena_alloc(JArena *arena, jsize_t size, jsize_t align)
+{
+    if (arena->chunk)
     {
-        jsize_t digit = (parser->input + start_pos)[i] - 48;
-        if (digit > 9)
+        JP_UINTPTR base = (JP_UINTPTR)(arena->chunk + 1);
+        JP_UINTPTR start = (base + arena->used + align - 1) & ~(JP_UINTPTR)(align - 1);
+        if (start + size <= base + arena->chunk->capacity)
         {
-            JValue value;
-            value.type = JSON_ERROR;
-            value.error = JSON_PARSE_ERROR;
-#if !defined(NDEBUG)
-            fprintf(stderr, "couldn't parse a number at %llu\n",
-                    start_pos + i + 1);
-#endif // NDEBUG
-            return value;
+            arena->used = start + size - base;
+            return (void *)start;
         }
-        number = number * 10 + digit;
-        i++;
     }
-    if (negative)
-        number = -(long long)number;
-    JValue value;
-    value.type = JSON_NUMBER;
-    value.number = number;
-    return value;
+    jsize_t capacity = arena->next_capacity < size + align ? size + align : arena->next_capacity;
+    JArenaChunk *chunk = (JArenaChunk *)arena->alloc(sizeof(JArenaChunk) + capacity);
+    if (chunk == 0)
+        return 0;
+    chunk->previous = arena->chunk;
+    chunk->capacity = capacity;
+    arena->chunk = chunk;
+    arena->used = 0;
+    arena->next_capacity = capacity * 2;
+    return json_arena_alloc(arena, size, align);
 }
 
-JValue json_parse_boolean(JParser *parser, int bool_value, const char *bool_string, jsize_t bool_string_length)
+// hands back every chunk but the largest, so a workload that is repeated
+// settles on a single chunk, unless it is over retain_limit
+void json_arena_reset(JArena *arena)
 {
-    if (json_memcmp(parser->input + parser->pos, bool_string, bool_string_length) == 0)
+    if (arena->chunk == 0)
+        return;
+    // adopted chunks may be bigger than the newest one
+    JArenaChunk *largest = arena->chunk;
+    for (JArenaChunk *chunk = largest->previous; chunk; chunk = chunk->previous)
     {
-        JValue value;
-        value.type = JSON_BOOL;
-        value.boolean = bool_value;
-        parser->pos += bool_string_length;
-        return value;
+        if (chunk->capacity > largest->capacity)
+            largest = chunk;
     }
-    JValue value;
-    value.type = JSON_ERROR;
-    value.error = JSON_PARSE_ERROR;
-#if !defined(NDEBUG)
-    fprintf(stderr, "failed to parse %s\n", bool_string);
-#endif // NDEBUG
-    return value;
+    JArenaChunk *chunk = arena->chunk;
+    arena->used = 0;
+    if (arena->retain_limit != 0 && largest->capacity > arena->retain_limit && arena->free)
+    {
+        largest = 0;
+        arena->next_capacity = JP_ARENA_CHUNK_SIZE;
+    }
+    arena->chunk = largest;
+    while (chunk)
+    {
+        JArenaChunk *previous = chunk->previous;
+        if (chunk != largest && arena->free)
+            arena->free(chunk);
+        chunk = previous;
+    }
+    if (largest)
+        largest->previous = 0;
 }
 
-JValue json_parse_null(JParser *parser)
+void json_arena_free(JArena *arena)
+{
+    json_arena_reset(arena);
+    if (arena->chunk && arena->free)
+        arena->free(arena->chunk);
+    arena->chunk = 0;
+    arena->next_capacity = JP_ARENA_CHUNK_SIZE;
+}
+
+// bytes held by the chunks, what a reset keeps of it is reused without
+// calling alloc
+jsize_t json_arena_capacity(const JArena *arena)
 {
-    if (json_memcmp(parser->input + parser->pos, "null", 4) == 0)
+    jsize_t capacity = 0;
+    for (JArenaChunk *chunk = arena->chunk; chunk; chunk = chunk->previous)
+        capacity += chunk->capacity;
+    return capacity;
+}
+
+// bytes handed out since the last reset, the unused tails of older chunks
+// included
+jsize_t json_arena_size(const JArena *arena)
+{
+    if (arena->chunk == 0)
+        return 0;
+    return json_arena_capacity(arena) - arena->chunk->capacity + arena->used;
+}
+
+// makes sure the next `capacity` bytes fit the newest chunk, an empty chunk
+// that is too small is replaced, returns 1 or JSON_MEMORY_ERROR
+int json_arena_reserve(JArena *arena, jsize_t capacity)
+{
+    if (arena->chunk && arena->used + capacity <= arena->chunk->capacity)
+        return 1;
+    if (arena->chunk && arena->used == 0 && arena->free)
     {
-        JValue value;
-        value.type = JSON_NULL;
-        value.null = 0;
-        parser->pos += 4;
-        return value;
+        JArenaChunk *chunk = arena->chunk;
+        arena->chunk = chunk->previous;
+        arena->free(chunk);
+        // what was left of the chunk before it is not tracked, it counts as
+        // full so that its allocations stay where they are
+        if (arena->chunk)
+            arena->used = arena->chunk->capacity;
     }
-    JValue value;
-    value.type = JSON_ERROR;
-    value.error = JSON_PARSE_ERROR;
-#if !defined(NDEBUG)
-    fprintf(stderr, "failed to parse null\n");
-#endif // NDEBUG
-    return value;
+    if (json_arena_alloc(arena, capacity, 1) == 0)
+        return JSON_MEMORY_ERROR;
+    arena->used -= capacity;
+    return 1;
 }
 
-JValue json_parse_array(JParser *parser)
+// moves the chunks of `other` behind the newest one of `arena`, which frees
+// them with its own free, `other` is left empty
+void json_arena_adopt(JArena *arena, JArena *other)
 {
-    parser->pos++;
-    if (!json_skip_whitespaces(parser))
-        return json_unexpected_eof(parser->pos);
-    JValue value;
-    value.type = JSON_ARRAY;
-    jsize_t start_pos = parser->pos;
-    if (parser->input[start_pos] == ']')
+    if (other->chunk == 0)
+        return;
+    if (arena->chunk == 0)
     {
-        value.array.data = 0;
-        value.array.length = 0;
-        parser->pos++;
-        return value;
+        arena->chunk = other->chunk;
+        arena->used = other->used;
     }
-    jsize_t array_values_count = 1;
-    jsize_t open_bracket_count = 1;
-    int inside_string = 0;
-    do
+    else
     {
-        if (parser->input[start_pos] == '\0')
-            return json_unexpected_eof(start_pos);
-        if (parser->input[start_pos] == '[')
-            open_bracket_count++;
-        if (parser->input[start_pos] == ']')
-            open_bracket_count--;
-        if (parser->input[start_pos] == '"')
-            inside_string = !inside_string;
-        if (!inside_string && open_bracket_count == 1 && parser->input[start_pos] == ',')
-            array_values_count++;
-        start_pos++;
-    } while (open_bracket_count != 0);
-    JValue *array_values = (JValue *)parser->memory->alloc(sizeof(JValue) * array_values_count);
-    if (array_values == 0)
+        JArenaChunk *oldest = other->chunk;
+        while (oldest->previous)
+            oldest = oldest->previous;
+        oldest->previous = arena->chunk->previous;
+        arena->chunk->previous = other->chunk;
+    }
+    other->chunk = 0;
+    other->used = 0;
+    other->next_capacity = JP_ARENA_CHUNK_SIZE;
+}
+
+// the tree lives until the arena is reset or freed
+JValue json_parse_arena(JArena *arena, const char *input, jsize_t length, int flags)
+{
+    JParser parser = json_init_parser(0, input);
+    parser.length = length;
+    parser.flags = flags;
+    parser.arena = arena;
+    return json_parse_root(&parser);
+}
+
+// the default entry points carve the tree from a JArena over
+// JP_DEFAULT_ALLOC, a handful of chunks instead of an allocation per string
+// and container, they leak by design like the JP_DEFAULT_ALLOC nodes they
+// replace, json_parse_document or json_parse_arena give the tree an owner
+// that json_free or json_arena_free release
+JValue json_parse(const char *input)
+{
+    JArena arena = json_arena_init();
+    return json_parse_arena(&arena, input, JSON_NUL_TERMINATED, 0);
+}
+
+JValue json_parse_view(const char *input)
+{
+    JArena arena = json_arena_init();
+    return json_parse_arena(&arena, input, JSON_NUL_TERMINATED, JSON_ZERO_COPY);
+}
+
+JValue json_parse_custom(JMemory *memory, const char *input)
+{
+    return json_parse_flags(memory, input, 0);
+}
+
+JValue json_parse_flags(JMemory *memory, const char *input, int flags)
+{
+    return json_parse_custom_n(memory, input, JSON_NUL_TERMINATED, flags);
+}
+
+JValue json_parse_n(const char *input, jsize_t length)
+{
+    JArena arena = json_arena_init();
+    return json_parse_arena(&arena, input, length, 0);
+}
+
+// the input does not need a terminator or padding, the SIMD paths only do
+// aligned loads, which stay inside the page of the last byte
+JValue json_parse_custom_n(JMemory *memory, const char *input, jsize_t length, int flags)
+{
+    JParser parser = json_init_parser(memory, input);
+    parser.length = length;
+    parser.flags = flags;
+    return json_parse_root(&parser);
+}
+
+JValue json_parse_insitu(char *input, jsize_t length)
+{
+    JArena arena = json_arena_init();
+    return json_parse_arena(&arena, input, length, JSON_INSITU);
+}
+
+// maps the whole file read-only, or copy-on-write with JSON_INSITU so that
+// the file itself is never written, returns 1 or JSON_FILE_ERROR
+int json_map_file(const char *path, int flags, JFile *file)
+{
+    file->data = "";
+    file->size = 0;
+#if defined(JP_MMAP) && defined(_WIN32)
+    file->mapping = 0;
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    LARGE_INTEGER size;
+    if (handle == INVALID_HANDLE_VALUE)
+        return JSON_FILE_ERROR;
+    // empty files can't be mapped
+    BOOL sized = GetFileSizeEx(handle, &size);
+    if (!sized || size.QuadPart == 0)
     {
-        JValue value;
-        value.type = JSON_ERROR;
-        value.error = JSON_MEMORY_ERROR;
-        return value;
+        CloseHandle(handle);
+        return sized ? 1 : JSON_FILE_ERROR;
     }
-    for (jsize_t i = 0; i < array_values_count; ++i)
+    int copy = (flags & JSON_INSITU) != 0;
+    HANDLE mapping = CreateFileMappingA(handle, 0, copy ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, 0);
+    // the mapping keeps its own reference to the file
+    CloseHandle(handle);
+    void *data = mapping ? MapViewOfFile(mapping, copy ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0) : 0;
+    if (data == 0)
     {
-        if (!json_skip_whitespaces(parser))
-            return json_unexpected_eof(parser->pos);
-        JValue value = json_parse_value(parser);
-        if (value.type == JSON_ERROR)
-            return value;
-        array_values[i] = value;
-        if (!json_skip_whitespaces(parser))
-            return json_unexpected_eof(parser->pos);
-        parser->pos++;
+        if (mapping)
+            CloseHandle(mapping);
+        return JSON_FILE_ERROR;
     }
-    value.array.data = array_values;
-    value.array.length = array_values_count;
-    return value;
+    file->data = (const char *)data;
+    file->size = (jsize_t)size.QuadPart;
+    file->mapping = mapping;
+    return 1;
+#elif defined(JP_MMAP)
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return JSON_FILE_ERROR;
+    }
+    if (info.st_size == 0)
+    {
+        close(fd);
+        return 1;
+    }
+    int copy = (flags & JSON_INSITU) != 0;
+    void *data = mmap(0, (size_t)info.st_size, copy ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED)
+        return JSON_FILE_ERROR;
+    // the parser reads the input front to back once, the hints are left out
+    // when a system header before jp.h already picked a strict C mode
+#if defined(MADV_SEQUENTIAL)
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+    madvise(data, (size_t)info.st_size, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+    madvise(data, (size_t)info.st_size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+#elif defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+    posix_madvise(data, (size_t)info.st_size, POSIX_MADV_WILLNEED);
+#endif // MADV_SEQUENTIAL
+    file->data = (const char *)data;
+    file->size = (jsize_t)info.st_size;
+    return 1;
+#else
+    (void)path;
+    (void)flags;
+    return JSON_FILE_ERROR;
+#endif // JP_MMAP
 }
 
-JValue json_unexpected_eof(jsize_t pos)
+void json_unmap_file(JFile *file)
+{
+#if defined(JP_MMAP) && defined(_WIN32)
+    if (file->mapping)
+    {
+        UnmapViewOfFile(file->data);
+        CloseHandle(file->mapping);
+    }
+    file->mapping = 0;
+#elif defined(JP_MMAP)
+    if (file->size)
+        munmap((void *)file->data, (size_t)file->size);
+#endif // JP_MMAP
+    file->data = "";
+    file->size = 0;
+}
+
+JValue json_file_error(const char *path, int error)
 {
     JValue value;
     value.type = JSON_ERROR;
-    value.error = JSON_UNEXPECTED_EOF;
+    value.error = (JCode)error;
 #if !defined(NDEBUG)
-    fprintf(stderr, "unexpected end of file at %llu\n", pos);
+    fprintf(stderr, "couldn't map %s\n", path);
+#else
+    (void)path;
 #endif // NDEBUG
     return value;
 }
 
-JValue json_parse_value(JParser *parser)
+// the tree lives in the arena and its strings point into the mapping,
+// json_arena_free and json_unmap_file release them
+JValue json_parse_file(JArena *arena, const char *path, JFile *file)
+{
+    int result = json_map_file(path, JSON_ZERO_COPY, file);
+    if (result != 1)
+        return json_file_error(path, result);
+    return json_parse_arena(arena, file->data, file->size, JSON_ZERO_COPY);
+}
+
+// parses the file straight from its mapping, which has to outlive the value
+// with JSON_ZERO_COPY, JSON_INSITU or JSON_LAZY_NUMBERS, json_unmap_file
+// releases it
+JValue json_parse_file_custom(JMemory *memory, const char *path, int flags, JFile *file)
+{
+    int result = json_map_file(path, flags, file);
+    if (result != 1)
+        return json_file_error(path, result);
+    return json_parse_custom_n(memory, file->data, file->size, flags);
+}
+
+// an empty document, nothing is allocated yet
+JDocument json_init_document(JArena arena)
+{
+    JDocument document;
+    document.root.type = JSON_NULL;
+    document.arena = arena;
+    document.file.data = "";
+    document.file.size = 0;
+#if defined(_WIN32)
+    document.file.mapping = 0;
+#endif // _WIN32
+    return document;
+}
+
+JDocument json_parse_document(const char *input, jsize_t length, int flags)
+{
+    JDocument document = json_init_document(json_arena_init());
+    document.root = json_parse_arena(&document.arena, input, length, flags);
+    return document;
+}
+
+// the root is the parsed value or the error, either way json_free releases
+// the document
+JDocument json_parse_document_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr), const char *input, jsize_t length, int flags)
 {
-    switch (parser->input[parser->pos])
+    JDocument document = json_init_document(json_arena_init_custom(alloc, free));
+    document.root = json_parse_arena(&document.arena, input, length, flags);
+    return document;
+}
+
+// the mapping lives as long as the document, so JSON_ZERO_COPY and
+// JSON_LAZY_NUMBERS are safe to use
+JDocument json_parse_document_file(const char *path, int flags)
+{
+    JDocument document = json_init_document(json_arena_init());
+    int result = json_map_file(path, flags, &document.file);
+    if (result != 1)
     {
-    case '{':
-        return json_parse_object(parser);
-    case '[':
-        return json_parse_array(parser);
-    case '"':
-        return json_parse_string(parser);
-    case '-':
-        return json_parse_number(parser, 1);
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-        return json_parse_number(parser, 0);
-    case 't':
-        return json_parse_boolean(parser, 1, "true", 4);
-    case 'f':
-        return json_parse_boolean(parser, 0, "false", 5);
-    case 'n':
-        return json_parse_null(parser);
-    default:
+        document.root = json_file_error(path, result);
+        return document;
+    }
+    document.root = json_parse_arena(&document.arena, document.file.data, document.file.size, flags);
+    return document;
+}
+
+// hands every chunk back at once and unmaps the file, the document is left
+// empty and can be freed again
+void json_free(JDocument *document)
+{
+    json_arena_free(&document->arena);
+    json_unmap_file(&document->file);
+    document->root.type = JSON_NULL;
+}
+
+// parses into the capacity the document already holds, which grows to the
+// largest input seen up to arena.retain_limit, so similar inputs stop
+// calling alloc after the first few, the previous root is gone
+JValue json_parse_reuse(JDocument *document, const char *input, jsize_t length, int flags)
+{
+    JArena *arena = &document->arena;
+    jsize_t high_water = json_arena_size(arena);
+    json_arena_reset(arena);
+    json_unmap_file(&document->file);
+    if (high_water != 0 && (arena->retain_limit == 0 || high_water <= arena->retain_limit))
+    {
+        // one chunk for what the last parse took across several
+        if (json_arena_reserve(arena, high_water) != 1)
         {
-            JValue value;
-            value.type = JSON_ERROR;
-            value.error = JSON_PARSE_ERROR;
-#if !defined(NDEBUG)
-            fprintf(stderr, "unknown char %c at %llu\n", parser->input[parser->pos], parser->pos);
-#endif // NDEBUG
-            return value;
+            document->root.type = JSON_ERROR;
+            document->root.error = JSON_MEMORY_ERROR;
+            return document->root;
         }
     }
+    document->root = json_parse_arena(arena, input, length, flags);
+    return document->root;
 }
 
-JValue json_parse_object(JParser *parser)
+jsize_t json_parse_lines(const char *input, jsize_t length, JLineCallback callback, void *user)
 {
-    int match = json_match_char(parser, '{');
-    if (match == JSON_UNEXPECTED_EOF)
-        return json_unexpected_eof(parser->pos);
-    if (match == JSON_PARSE_ERROR)
+    JArena arena = json_arena_init();
+    jsize_t errors = json_parse_lines_custom(&arena, input, length, 0, callback, user);
+    json_arena_free(&arena);
+    return errors;
+}
+
+// parses newline delimited records, blank lines are skipped and malformed
+// ones are passed to the callback as errors, returns how many there were,
+// the arena is reset for every record, so it settles on a chunk that fits
+// the largest one and keeps it for the next call, line numbers start at 1
+jsize_t json_parse_lines_custom(JArena *arena, const char *input, jsize_t length, int flags, JLineCallback callback, void *user)
+{
+    JParser parser = json_init_parser(0, input);
+    parser.flags = flags;
+    parser.arena = arena;
+    jsize_t line = 0;
+    return json_parse_line_range(&parser, input, length, &line, 0, callback, user);
+}
+
+// parses the lines of input[0, length) into the parser's arena, numbered
+// after `line`, which ends up at the last one, `keep` leaves every record of
+// the range in the arena instead of resetting it for the next one
+jsize_t json_parse_line_range(JParser *parser, const char *input, jsize_t length, jsize_t *line, int keep,
+                              JLineCallback callback, void *user)
+{
+    jsize_t errors = 0;
+    for (jsize_t start = 0; start < length; ++*line)
+    {
+        jsize_t end = json_find_newline(input, start, length);
+        parser->input = input + start;
+        parser->length = end - start;
+        parser->pos = 0;
+        start = end + 1;
+        if (!json_skip_whitespaces(parser))
+            continue;
+        parser->pos = 0;
+        if (!keep)
+            json_reset_parser(parser);
+        parser->scratch_size = 0;
+        JValue value = json_parse_line(parser);
+        if (value.type == JSON_ERROR)
+            errors++;
+        callback(user, *line + 1, value);
+    }
+    return errors;
+}
+
+// a record has to fill its whole line
+JValue json_parse_line(JParser *parser)
+{
+    JValue value = json_parse_root(parser);
+    if (value.type != JSON_ERROR && json_skip_whitespaces(parser))
     {
-        JValue value;
-        value.type = JSON_ERROR;
-        value.error = JSON_PARSE_ERROR;
 #if !defined(NDEBUG)
-        fprintf(stderr, "expected '%c' found '%c' at %llu\n", '{',
-                parser->input[parser->pos - 1], parser->pos - 1);
+        fprintf(stderr, "unexpected '%c' after the record at %llu\n", json_peek(parser), parser->pos);
 #endif // NDEBUG
-        return value;
+        value.type = JSON_ERROR;
+        value.error = JSON_PARSE_ERROR;
     }
+    return value;
+}
 
-    JPair *pairs_start = (JPair *)(parser->memory->base +
-                                   sizeof(JPair) * parser->pairs_commited);
-    JValue value;
-    value.type = JSON_OBJECT;
-    value.object.data = pairs_start;
-    value.object.length = 0;
+// walks documents that follow each other with whitespaces or nothing in
+// between, a number has to be followed by a whitespace, the arena is reset
+// for every document, so it settles on a chunk that fits the largest one,
+// it is the caller's to free once the walk is done
+JMany json_parse_many(JArena *arena, const char *input, jsize_t length, int flags)
+{
+    JMany many;
+    many.parser = json_init_parser(0, input);
+    many.parser.flags = flags;
+    many.parser.arena = arena;
+    many.input = input;
+    many.length = length;
+    many.offset = 0;
+    many.error = 1;
+    return many;
+}
 
-    jsize_t i = parser->pos;
-    do
+// returns 1 with the next document and the offset right after it, which
+// lives until the next call, 0 when only whitespaces are left, or the JCode
+// that stops the walk, the document is that error then
+int json_many_next(JMany *many, JValue *document, jsize_t *end)
+{
+    if (many->error != 1)
     {
-        if (parser->input[i] == '\0')
-            return json_unexpected_eof(i);
-        if (parser->input[i] == '{')
-        {
-            jsize_t open_curly_count = 1;
-            do
-            {
-                i++;
-                if (parser->input[i] == '\0')
-                    return json_unexpected_eof(i);
-                if (parser->input[i] == '{')
-                    open_curly_count++;
-                if (parser->input[i] == '}')
-                    open_curly_count--;
-            } while (open_curly_count != 0);
-            i++;
-        }
-        if (parser->input[i] == ':' && parser->input[i - 1] == '"' &&
-            parser->input[i - 2] != '\\')
-            parser->pairs_commited++;
-    } while (parser->input[i++] != '}');
-
-parse_pair:
+        document->type = JSON_ERROR;
+        document->error = (JCode)many->error;
+        return many->error;
+    }
+    JParser *parser = &many->parser;
+    parser->input = many->input + many->offset;
+    parser->length = many->length == JSON_NUL_TERMINATED ? JSON_NUL_TERMINATED : many->length - many->offset;
+    parser->pos = 0;
+    if (!json_skip_whitespaces(parser))
+    {
+        many->offset += parser->pos;
+        return 0;
+    }
+    json_reset_parser(parser);
+    *document = json_parse_value(parser);
+    if (document->type == JSON_ERROR)
+        return many->error = document->error;
+    many->offset += parser->pos;
+    *end = many->offset;
+    return 1;
+}
+
+#if defined(JP_THREADS)
+typedef struct
+{
+    void (*task)(void *arg);
+    void *arg;
+} JThreadStart;
+
+#if defined(_WIN32)
+DWORD WINAPI json_thread_main(LPVOID start)
+{
+    ((JThreadStart *)start)->task(((JThreadStart *)start)->arg);
+    return 0;
+}
+#else
+void *json_thread_main(void *start)
+{
+    ((JThreadStart *)start)->task(((JThreadStart *)start)->arg);
+    return 0;
+}
+#endif // _WIN32
+#endif // JP_THREADS
+
+// runs task on every one of `count` args, each on its own thread, and waits
+// for all of them, the calling thread takes the last one and any task a
+// thread couldn't be started for
+void json_parallel(void (*task)(void *arg), void *args, jsize_t arg_size, int count)
+{
+    if (count < 1)
+        return;
+#if defined(JP_THREADS)
+    JThreadStart starts[JP_MAX_THREADS];
+#if defined(_WIN32)
+    HANDLE threads[JP_MAX_THREADS];
+#else
+    pthread_t threads[JP_MAX_THREADS];
+#endif // _WIN32
+    int started[JP_MAX_THREADS];
+    for (int i = 0; i < count - 1; ++i)
+    {
+        starts[i].task = task;
+        starts[i].arg = (char *)args + arg_size * i;
+#if defined(_WIN32)
+        threads[i] = CreateThread(0, 0, json_thread_main, starts + i, 0, 0);
+        started[i] = threads[i] != 0;
+#else
+        started[i] = pthread_create(threads + i, 0, json_thread_main, starts + i) == 0;
+#endif // _WIN32
+        if (!started[i])
+            task(starts[i].arg);
+    }
+    task((char *)args + arg_size * (count - 1));
+    for (int i = 0; i < count - 1; ++i)
+    {
+        if (!started[i])
+            continue;
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], 0);
+#endif // _WIN32
+    }
+#else
+    for (int i = 0; i < count; ++i)
+        task((char *)args + arg_size * i);
+#endif // JP_THREADS
+}
+
+// collects the records of a range to be delivered in order
+void json_lines_keep(void *user, jsize_t line, JValue value)
+{
+    JLinesWorker *worker = (JLinesWorker *)user;
+    if (worker->records_count == worker->records_capacity)
     {
+        jsize_t capacity = worker->records_capacity ? worker->records_capacity * 2 : JP_SCRATCH_INITIAL_SIZE;
+        JLineRecord *records =
+            (JLineRecord *)json_arena_alloc(worker->parser.arena, sizeof(JLineRecord) * capacity, 8);
+        if (records == 0)
         {
-            int match = json_match_char(parser, '"');
-            if (match == JSON_UNEXPECTED_EOF)
+            worker->dropped++;
+            return;
+        }
+        json_memcpy(records, worker->records, sizeof(JLineRecord) * worker->records_count);
+        worker->records = records;
+        worker->records_capacity = capacity;
+    }
+    worker->records[worker->records_count].line = line;
+    worker->records[worker->records_count].value = value;
+    worker->records_count++;
+}
+
+// every share but the last ends with a newline, so its lines are its newlines
+void json_lines_count(void *arg)
+{
+    JLinesWorker *worker = (JLinesWorker *)arg;
+    worker->line = json_count_newlines(worker->input, worker->length);
+}
+
+void json_lines_work(void *arg)
+{
+    JLinesWorker *worker = (JLinesWorker *)arg;
+    json_reset_parser(&worker->parser);
+    worker->records = 0;
+    worker->records_count = 0;
+    worker->records_capacity = 0;
+    if (worker->callback)
+        worker->errors = json_parse_line_range(&worker->parser, worker->input, worker->length, &worker->line, 0,
+                                               worker->callback, worker->user);
+    else
+    {
+        worker->dropped = 0;
+        worker->errors = json_parse_line_range(&worker->parser, worker->input, worker->length, &worker->line, 1,
+                                               json_lines_keep, worker);
+        worker->errors += worker->dropped;
+    }
+}
+
+// json_parse_lines_custom on `threads` threads, the first one parses into
+// `arena` and the others into arenas of their own over the same alloc and
+// free, which are freed before returning, so alloc has to be thread-safe, in
+// order the records are parsed a chunk per worker at a time and handed to
+// the callback from the calling thread, with JSON_LINES_UNORDERED every
+// worker takes an even share of the lines and calls back as soon as a record
+// is parsed, records there is no memory to keep in order are only counted as
+// errors
+jsize_t json_parse_lines_parallel(JArena *arena, const char *input, jsize_t length, int flags, int threads,
+                                  JLineCallback callback, void *user)
+{
+    JLinesWorker workers[JP_MAX_THREADS];
+    if (threads < 1)
+        threads = 1;
+    if (threads > JP_MAX_THREADS)
+        threads = JP_MAX_THREADS;
+    for (int i = 0; i < threads; ++i)
+    {
+        JLinesWorker *worker = workers + i;
+        worker->arena = json_arena_init_custom(arena->alloc, arena->free);
+        worker->parser = json_init_parser(0, input);
+        worker->parser.flags = flags;
+        worker->parser.arena = i ? &worker->arena : arena;
+        worker->line = 0;
+        worker->errors = 0;
+        worker->callback = (flags & JSON_LINES_UNORDERED) ? callback : 0;
+        worker->user = user;
+        worker->records = 0;
+        worker->records_count = 0;
+        worker->records_capacity = 0;
+        worker->dropped = 0;
+    }
+    jsize_t errors = 0;
+    jsize_t line = 0;
+    jsize_t chunk_size = JP_LINES_CHUNK_SIZE;
+    if (flags & JSON_LINES_UNORDERED)
+        chunk_size = length / (jsize_t)threads + 1;
+    for (jsize_t pos = 0; pos < length;)
+    {
+        int count = 0;
+        for (; count < threads && pos < length; ++count)
+        {
+            jsize_t end = length - pos > chunk_size ? json_find_newline(input, pos + chunk_size, length) : length;
+            end = end < length ? end + 1 : length;
+            workers[count].input = input + pos;
+            workers[count].length = end - pos;
+            pos = end;
+        }
+        if (flags & JSON_LINES_UNORDERED)
+        {
+            // the workers need the number of their first line before they
+            // start, so the newlines of every share but the last are
+            // counted first
+            json_parallel(json_lines_count, workers, sizeof(JLinesWorker), count - 1);
+            for (int i = 0; i < count; ++i)
+            {
+                jsize_t lines = workers[i].line;
+                workers[i].line = line;
+                line += lines;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+                workers[i].line = 0;
+        }
+        json_parallel(json_lines_work, workers, sizeof(JLinesWorker), count);
+        for (int i = 0; i < count; ++i)
+        {
+            errors += workers[i].errors;
+            if (flags & JSON_LINES_UNORDERED)
+                continue;
+            for (jsize_t j = 0; j < workers[i].records_count; ++j)
+                callback(user, line + workers[i].records[j].line, workers[i].records[j].value);
+            line += workers[i].line;
+        }
+    }
+    for (int i = 1; i < threads; ++i)
+        json_arena_free(&workers[i].arena);
+    return errors;
+}
+
+JValue json_parse_root(JParser *parser)
+{
+    json_skip_whitespaces(parser);
+    return json_parse_value(parser);
+}
+
+// a copy of the value, json_as_int and friends only cache the conversion of
+// a JSON_RAW_NUMBER in the copy, see json_get_ptr
+JValue json_get(JObject *object, const char *key)
+{
+    JValue *found = json_get_ptr(object, key);
+    if (found)
+        return *found;
+    JValue value;
+    value.type = JSON_ERROR;
+    value.error = JSON_KEY_NOT_FOUND;
+    return value;
+}
+
+// the value in the tree, or 0 when the key is missing
+JValue *json_get_ptr(JObject *object, const char *key)
+{
+    for (jsize_t i = 0; i < object->length; ++i)
+    {
+        JPair *pair = object->data + i;
+        if (json_memcmp(key, pair->key, pair->key_length) == 0 && key[pair->key_length] == '\0')
+            return &pair->value;
+    }
+#if !defined(NDEBUG)
+    fprintf(stderr, "key \"%s\" was not found\n", key);
+#endif // NDEBUG
+    return 0;
+}
+
+// the json_as_int and friends of a field, a JSON_RAW_NUMBER is converted in
+// the tree, so later reads of it don't convert again
+int json_get_int(JObject *object, const char *key, long long *result)
+{
+    JValue *value = json_get_ptr(object, key);
+    return value ? json_as_int(value, result) : JSON_KEY_NOT_FOUND;
+}
+
+int json_get_uint(JObject *object, const char *key, unsigned long long *result)
+{
+    JValue *value = json_get_ptr(object, key);
+    return value ? json_as_uint(value, result) : JSON_KEY_NOT_FOUND;
+}
+
+int json_get_double(JObject *object, const char *key, double *result)
+{
+    JValue *value = json_get_ptr(object, key);
+    return value ? json_as_double(value, result) : JSON_KEY_NOT_FOUND;
+}
+
+JValue json_parse_string(JParser *parser)
+{
+    parser->pos++;
+    jsize_t start = parser->pos;
+    int has_escapes = 0;
+    for (;;)
+    {
+        parser->pos = json_scan_string(parser->input, parser->pos, parser->length);
+        char c = json_peek(parser);
+        if (c == '"')
+            break;
+        if (c == '\\')
+        {
+            parser->pos++;
+            if (json_peek(parser) == '\0')
                 return json_unexpected_eof(parser->pos);
-            if (match == JSON_PARSE_ERROR)
+            has_escapes = 1;
+            parser->pos++;
+            continue;
+        }
+        if (c == '\0')
+            return json_unexpected_eof(parser->pos);
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+        fprintf(stderr, "unescaped control character 0x%02x in string at %llu\n",
+                (unsigned int)(unsigned char)c, parser->pos);
+#endif // NDEBUG
+        return value;
+    }
+    char *value_string = 0;
+    jsize_t string_length = parser->pos - start;
+    if (!json_length_fits(string_length))
+        return json_too_long(parser->pos);
+    // empty strings are null unless they can be terminated in place
+    if (string_length != 0 || (parser->flags & JSON_INSITU))
+    {
+        const char *source = parser->input + start;
+        int terminate = 1;
+        if (parser->flags & JSON_INSITU)
+            value_string = (char *)source;
+        else if (!has_escapes && (parser->flags & JSON_ZERO_COPY))
+        {
+            value_string = (char *)source;
+            terminate = 0;
+        }
+        else
+        {
+            // round up so that bump allocators stay aligned for the containers
+            // that are allocated after their strings
+            value_string = (char *)json_alloc(parser, (string_length + 1 + 7) & ~(jsize_t)7);
+            if (value_string == 0)
+            {
+                JValue value;
+                value.type = JSON_ERROR;
+                value.error = JSON_MEMORY_ERROR;
+                return value;
+            }
+        }
+        if (has_escapes)
+        {
+            if (json_unescape(value_string, source, string_length, &string_length) != 1)
             {
-                if (parser->input[parser->pos - 1] == '}')
-                {
-                    value.object.data = 0;
-                    return value;
-                }
                 JValue value;
                 value.type = JSON_ERROR;
                 value.error = JSON_PARSE_ERROR;
 #if !defined(NDEBUG)
-                fprintf(stderr, "expected '%c' found '%c' at %llu\n", '"',
-                        parser->input[parser->pos - 1], parser->pos - 1);
+                fprintf(stderr, "invalid escape sequence in string at %llu\n", start);
 #endif // NDEBUG
                 return value;
             }
         }
+        else if (value_string != source)
+            json_memcpy(value_string, source, string_length);
+        if (terminate)
+            value_string[string_length] = '\0';
+    }
+    JValue value;
+    value.type = JSON_STRING;
+    value.string.data = value_string;
+    value.string.length = string_length;
+    parser->pos++;
+    return value;
+}
 
-        parser->pos--;
+// whether 8 bytes can be read at `pos` without reading past the input, or
+// past the page of a terminated input
+int json_can_load64(const char *input, jsize_t pos, jsize_t length)
+{
+    if (length == JSON_NUL_TERMINATED)
+        return ((JP_UINTPTR)(input + pos) & 4095) <= 4096 - 8;
+    return pos + 8 <= length;
+}
 
-        JValue key_value = json_parse_string(parser);
-        if (key_value.type == JSON_ERROR)
-            return key_value;
+int json_is_eight_digits(unsigned long long chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+           0x3333333333333333;
+}
 
-        char *key = key_value.string.data;
+// value of 8 digits loaded with json_load64, first digit in the low byte
+unsigned long long json_parse_eight_digits(unsigned long long chunk)
+{
+    chunk -= 0x3030303030303030;
+    // pairs, then quads, then all 8
+    chunk = (chunk * 10) + (chunk >> 8);
+    return (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+            (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+           32;
+}
 
+int json_scan_number(const char *input, jsize_t pos, jsize_t length, JNumber *number, jsize_t *end)
+{
+    number->mantissa = 0;
+    number->exponent = 0;
+    number->negative = 0;
+    number->integer = 1;
+    number->truncated = 0;
+    if (pos < length && input[pos] == '-')
+    {
+        number->negative = 1;
+        pos++;
+    }
+    jsize_t start = pos;
+    if (pos < length && input[pos] == '0')
+    {
+        pos++;
+        if (pos < length && (unsigned int)((unsigned char)input[pos] - '0') <= 9)
+            return JSON_PARSE_ERROR;
+    }
+    else
+    {
+        // 16 digits never overflow, the 8 bytes past a terminator are only
+        // read when they are in the same page
+        unsigned long long chunk;
+        while (pos - start <= 8 && json_can_load64(input, pos, length) &&
+               json_is_eight_digits(chunk = json_load64(input + pos)))
         {
-            int match = json_match_char(parser, ':');
-            if (match == JSON_UNEXPECTED_EOF)
-                return json_unexpected_eof(parser->pos);
-            if (match == JSON_PARSE_ERROR)
+            number->mantissa = number->mantissa * 100000000 + json_parse_eight_digits(chunk);
+            pos += 8;
+        }
+        for (unsigned int digit; pos < length && (digit = (unsigned char)input[pos] - '0') <= 9; ++pos)
+        {
+            if (pos - start < 19)
+                number->mantissa = number->mantissa * 10 + digit;
+            else
             {
-                JValue error_value;
-                error_value.type = JSON_ERROR;
-                error_value.error = JSON_PARSE_ERROR;
-#if !defined(NDEBUG)
-                fprintf(stderr, "expected '%c' found '%c' at %llu\n", ':',
-                        parser->input[parser->pos - 1], parser->pos - 1);
-#endif // NDEBUG
-                return error_value;
+                number->exponent++;
+                number->truncated |= digit != 0;
             }
         }
-        if (!json_skip_whitespaces(parser))
-            return json_unexpected_eof(parser->pos);
+        if (pos == start)
+            return JSON_PARSE_ERROR;
+    }
+    // without leading zeros every digit but a lone zero is significant
+    int significant = number->mantissa != 0 ? (int)(pos - start < 19 ? pos - start : 19) : 0;
+    if (pos < length && input[pos] == '.')
+    {
+        number->integer = 0;
+        start = ++pos;
+        for (unsigned int digit; pos < length && (digit = (unsigned char)input[pos] - '0') <= 9; ++pos)
+        {
+            if (significant < 19)
+            {
+                number->mantissa = number->mantissa * 10 + digit;
+                significant += number->mantissa != 0;
+                number->exponent--;
+            }
+            else
+                number->truncated |= digit != 0;
+        }
+        if (pos == start)
+            return JSON_PARSE_ERROR;
+    }
+    if (pos < length && (input[pos] == 'e' || input[pos] == 'E'))
+    {
+        number->integer = 0;
+        int negative_exponent = 0;
+        pos++;
+        if (pos < length && (input[pos] == '-' || input[pos] == '+'))
+            negative_exponent = input[pos++] == '-';
+        long long exponent = 0;
+        start = pos;
+        for (unsigned int digit; pos < length && (digit = (unsigned char)input[pos] - '0') <= 9; ++pos)
+        {
+            // anything past this is zero or infinity anyway
+            if (exponent < 100000)
+                exponent = exponent * 10 + digit;
+        }
+        if (pos == start)
+            return JSON_PARSE_ERROR;
+        number->exponent += negative_exponent ? -exponent : exponent;
+    }
+    // a 20th digit still fits when the first 19 are at most ULLONG_MAX / 10
+    if (number->integer && number->exponent == 1)
+    {
+        unsigned int digit = (unsigned char)input[pos - 1] - '0';
+        if (number->mantissa < 1844674407370955161ULL || (number->mantissa == 1844674407370955161ULL && digit <= 5))
+        {
+            number->mantissa = number->mantissa * 10 + digit;
+            number->exponent = 0;
+            number->truncated = 0;
+        }
+    }
+    *end = pos;
+    return 1;
+}
 
-        JValue object_value = json_parse_value(parser);
-        if (object_value.type == JSON_ERROR)
-            return object_value;
+jsize_t json_skip_digits(const char *input, jsize_t pos, jsize_t length)
+{
+    while (json_can_load64(input, pos, length) && json_is_eight_digits(json_load64(input + pos)))
+        pos += 8;
+    while (pos < length && (unsigned int)((unsigned char)input[pos] - '0') <= 9)
+        pos++;
+    return pos;
+}
 
-        value.object.data[value.object.length].key = key;
-        value.object.data[value.object.length].value = object_value;
-        value.object.length++;
+// the grammar of json_scan_number without converting anything
+int json_validate_number(const char *input, jsize_t pos, jsize_t length, jsize_t *end)
+{
+    if (pos < length && input[pos] == '-')
+        pos++;
+    jsize_t start = pos;
+    if (pos < length && input[pos] == '0')
+    {
+        pos++;
+        if (pos < length && (unsigned int)((unsigned char)input[pos] - '0') <= 9)
+            return JSON_PARSE_ERROR;
+    }
+    else if ((pos = json_skip_digits(input, pos, length)) == start)
+        return JSON_PARSE_ERROR;
+    if (pos < length && input[pos] == '.')
+    {
+        start = ++pos;
+        if ((pos = json_skip_digits(input, pos, length)) == start)
+            return JSON_PARSE_ERROR;
+    }
+    if (pos < length && (input[pos] == 'e' || input[pos] == 'E'))
+    {
+        pos++;
+        if (pos < length && (input[pos] == '-' || input[pos] == '+'))
+            pos++;
+        start = pos;
+        if ((pos = json_skip_digits(input, pos, length)) == start)
+            return JSON_PARSE_ERROR;
+    }
+    *end = pos;
+    return 1;
+}
 
-        if (!json_skip_whitespaces(parser))
-            return json_unexpected_eof(parser->pos);
+const double json_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
 
-        if (parser->input[parser->pos] == ',')
+// 128-bit approximations of 5^q for q in [-342, 308], normalized so the top
+// bit is set, high word first
+const unsigned long long json_powers_of_five[] = {
+    0xeef453d6923bd65a, 0x113faa2906a13b3f,
+    0x9558b4661b6565f8, 0x4ac7ca59a424c507,
+    0xbaaee17fa23ebf76, 0x5d79bcf00d2df649,
+    0xe95a99df8ace6f53, 0xf4d82c2c107973dc,
+    0x91d8a02bb6c10594, 0x79071b9b8a4be869,
+    0xb64ec836a47146f9, 0x9748e2826cdee284,
+    0xe3e27a444d8d98b7, 0xfd1b1b2308169b25,
+    0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7,
+    0xb208ef855c969f4f, 0xbdbd2d335e51a935,
+    0xde8b2b66b3bc4723, 0xad2c788035e61382,
+    0x8b16fb203055ac76, 0x4c3bcb5021afcc31,
+    0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d,
+    0xd953e8624b85dd78, 0xd71d6dad34a2af0d,
+    0x87d4713d6f33aa6b, 0x8672648c40e5ad68,
+    0xa9c98d8ccb009506, 0x680efdaf511f18c2,
+    0xd43bf0effdc0ba48, 0x0212bd1b2566def2,
+    0x84a57695fe98746d, 0x014bb630f7604b57,
+    0xa5ced43b7e3e9188, 0x419ea3bd35385e2d,
+    0xcf42894a5dce35ea, 0x52064cac828675b9,
+    0x818995ce7aa0e1b2, 0x7343efebd1940993,
+    0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8,
+    0xca66fa129f9b60a6, 0xd41a26e077774ef6,
+    0xfd00b897478238d0, 0x8920b098955522b4,
+    0x9e20735e8cb16382, 0x55b46e5f5d5535b0,
+    0xc5a890362fddbc62, 0xeb2189f734aa831d,
+    0xf712b443bbd52b7b, 0xa5e9ec7501d523e4,
+    0x9a6bb0aa55653b2d, 0x47b233c92125366e,
+    0xc1069cd4eabe89f8, 0x999ec0bb696e840a,
+    0xf148440a256e2c76, 0xc00670ea43ca250d,
+    0x96cd2a865764dbca, 0x380406926a5e5728,
+    0xbc807527ed3e12bc, 0xc605083704f5ecf2,
+    0xeba09271e88d976b, 0xf7864a44c633682e,
+    0x93445b8731587ea3, 0x7ab3ee6afbe0211d,
+    0xb8157268fdae9e4c, 0x5960ea05bad82964,
+    0xe61acf033d1a45df, 0x6fb92487298e33bd,
+    0x8fd0c16206306bab, 0xa5d3b6d479f8e056,
+    0xb3c4f1ba87bc8696, 0x8f48a4899877186c,
+    0xe0b62e2929aba83c, 0x331acdabfe94de87,
+    0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14,
+    0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9,
+    0xdb71e91432b1a24a, 0xc9e82cd9f69d6150,
+    0x892731ac9faf056e, 0xbe311c083a225cd2,
+    0xab70fe17c79ac6ca, 0x6dbd630a48aaf406,
+    0xd64d3d9db981787d, 0x092cbbccdad5b108,
+    0x85f0468293f0eb4e, 0x25bbf56008c58ea5,
+    0xa76c582338ed2621, 0xaf2af2b80af6f24e,
+    0xd1476e2c07286faa, 0x1af5af660db4aee1,
+    0x82cca4db847945ca, 0x50d98d9fc890ed4d,
+    0xa37fce126597973c, 0xe50ff107bab528a0,
+    0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8,
+    0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a,
+    0x9faacf3df73609b1, 0x77b191618c54e9ac,
+    0xc795830d75038c1d, 0xd59df5b9ef6a2417,
+    0xf97ae3d0d2446f25, 0x4b0573286b44ad1d,
+    0x9becce62836ac577, 0x4ee367f9430aec32,
+    0xc2e801fb244576d5, 0x229c41f793cda73f,
+    0xf3a20279ed56d48a, 0x6b43527578c1110f,
+    0x9845418c345644d6, 0x830a13896b78aaa9,
+    0xbe5691ef416bd60c, 0x23cc986bc656d553,
+    0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8,
+    0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9,
+    0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53,
+    0xe858ad248f5c22c9, 0xd1b3400f8f9cff68,
+    0x91376c36d99995be, 0x23100809b9c21fa1,
+    0xb58547448ffffb2d, 0xabd40a0c2832a78a,
+    0xe2e69915b3fff9f9, 0x16c90c8f323f516c,
+    0x8dd01fad907ffc3b, 0xae3da7d97f6792e3,
+    0xb1442798f49ffb4a, 0x99cd11cfdf41779c,
+    0xdd95317f31c7fa1d, 0x40405643d711d583,
+    0x8a7d3eef7f1cfc52, 0x482835ea666b2572,
+    0xad1c8eab5ee43b66, 0xda3243650005eecf,
+    0xd863b256369d4a40, 0x90bed43e40076a82,
+    0x873e4f75e2224e68, 0x5a7744a6e804a291,
+    0xa90de3535aaae202, 0x711515d0a205cb36,
+    0xd3515c2831559a83, 0x0d5a5b44ca873e03,
+    0x8412d9991ed58091, 0xe858790afe9486c2,
+    0xa5178fff668ae0b6, 0x626e974dbe39a872,
+    0xce5d73ff402d98e3, 0xfb0a3d212dc8128f,
+    0x80fa687f881c7f8e, 0x7ce66634bc9d0b99,
+    0xa139029f6a239f72, 0x1c1fffc1ebc44e80,
+    0xc987434744ac874e, 0xa327ffb266b56220,
+    0xfbe9141915d7a922, 0x4bf1ff9f0062baa8,
+    0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9,
+    0xc4ce17b399107c22, 0xcb550fb4384d21d3,
+    0xf6019da07f549b2b, 0x7e2a53a146606a48,
+    0x99c102844f94e0fb, 0x2eda7444cbfc426d,
+    0xc0314325637a1939, 0xfa911155fefb5308,
+    0xf03d93eebc589f88, 0x793555ab7eba27ca,
+    0x96267c7535b763b5, 0x4bc1558b2f3458de,
+    0xbbb01b9283253ca2, 0x9eb1aaedfb016f16,
+    0xea9c227723ee8bcb, 0x465e15a979c1cadc,
+    0x92a1958a7675175f, 0x0bfacd89ec191ec9,
+    0xb749faed14125d36, 0xcef980ec671f667b,
+    0xe51c79a85916f484, 0x82b7e12780e7401a,
+    0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810,
+    0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15,
+    0xdfbdcece67006ac9, 0x67a791e093e1d49a,
+    0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0,
+    0xaecc49914078536d, 0x58fae9f773886e18,
+    0xda7f5bf590966848, 0xaf39a475506a899e,
+    0x888f99797a5e012d, 0x6d8406c952429603,
+    0xaab37fd7d8f58178, 0xc8e5087ba6d33b83,
+    0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64,
+    0x855c3be0a17fcd26, 0x5cf2eea09a55067f,
+    0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e,
+    0xd0601d8efc57b08b, 0xf13b94daf124da26,
+    0x823c12795db6ce57, 0x76c53d08d6b70858,
+    0xa2cb1717b52481ed, 0x54768c4b0c64ca6e,
+    0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09,
+    0xfe5d54150b090b02, 0xd3f93b35435d7c4c,
+    0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf,
+    0xc6b8e9b0709f109a, 0x359ab6419ca1091b,
+    0xf867241c8cc6d4c0, 0xc30163d203c94b62,
+    0x9b407691d7fc44f8, 0x79e0de63425dcf1d,
+    0xc21094364dfb5636, 0x985915fc12f542e4,
+    0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d,
+    0x979cf3ca6cec5b5a, 0xa705992ceecf9c42,
+    0xbd8430bd08277231, 0x50c6ff782a838353,
+    0xece53cec4a314ebd, 0xa4f8bf5635246428,
+    0x940f4613ae5ed136, 0x871b7795e136be99,
+    0xb913179899f68584, 0x28e2557b59846e3f,
+    0xe757dd7ec07426e5, 0x331aeada2fe589cf,
+    0x9096ea6f3848984f, 0x3ff0d2c85def7621,
+    0xb4bca50b065abe63, 0x0fed077a756b53a9,
+    0xe1ebce4dc7f16dfb, 0xd3e8495912c62894,
+    0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c,
+    0xb080392cc4349dec, 0xbd8d794d96aacfb3,
+    0xdca04777f541c567, 0xecf0d7a0fc5583a0,
+    0x89e42caaf9491b60, 0xf41686c49db57244,
+    0xac5d37d5b79b6239, 0x311c2875c522ced5,
+    0xd77485cb25823ac7, 0x7d633293366b828b,
+    0x86a8d39ef77164bc, 0xae5dff9c02033197,
+    0xa8530886b54dbdeb, 0xd9f57f830283fdfc,
+    0xd267caa862a12d66, 0xd072df63c324fd7b,
+    0x8380dea93da4bc60, 0x4247cb9e59f71e6d,
+    0xa46116538d0deb78, 0x52d9be85f074e608,
+    0xcd795be870516656, 0x67902e276c921f8b,
+    0x806bd9714632dff6, 0x00ba1cd8a3db53b6,
+    0xa086cfcd97bf97f3, 0x80e8a40eccd228a4,
+    0xc8a883c0fdaf7df0, 0x6122cd128006b2cd,
+    0xfad2a4b13d1b5d6c, 0x796b805720085f81,
+    0x9cc3a6eec6311a63, 0xcbe3303674053bb0,
+    0xc3f490aa77bd60fc, 0xbedbfc4411068a9c,
+    0xf4f1b4d515acb93b, 0xee92fb5515482d44,
+    0x991711052d8bf3c5, 0x751bdd152d4d1c4a,
+    0xbf5cd54678eef0b6, 0xd262d45a78a0635d,
+    0xef340a98172aace4, 0x86fb897116c87c34,
+    0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0,
+    0xbae0a846d2195712, 0x8974836059cca109,
+    0xe998d258869facd7, 0x2bd1a438703fc94b,
+    0x91ff83775423cc06, 0x7b6306a34627ddcf,
+    0xb67f6455292cbf08, 0x1a3bc84c17b1d542,
+    0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93,
+    0x8e938662882af53e, 0x547eb47b7282ee9c,
+    0xb23867fb2a35b28d, 0xe99e619a4f23aa43,
+    0xdec681f9f4c31f31, 0x6405fa00e2ec94d4,
+    0x8b3c113c38f9f37e, 0xde83bc408dd3dd04,
+    0xae0b158b4738705e, 0x9624ab50b148d445,
+    0xd98ddaee19068c76, 0x3badd624dd9b0957,
+    0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6,
+    0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c,
+    0xd47487cc8470652b, 0x7647c3200069671f,
+    0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073,
+    0xa5fb0a17c777cf09, 0xf468107100525890,
+    0xcf79cc9db955c2cc, 0x7182148d4066eeb4,
+    0x81ac1fe293d599bf, 0xc6f14cd848405530,
+    0xa21727db38cb002f, 0xb8ada00e5a506a7c,
+    0xca9cf1d206fdc03b, 0xa6d90811f0e4851c,
+    0xfd442e4688bd304a, 0x908f4a166d1da663,
+    0x9e4a9cec15763e2e, 0x9a598e4e043287fe,
+    0xc5dd44271ad3cdba, 0x40eff1e1853f29fd,
+    0xf7549530e188c128, 0xd12bee59e68ef47c,
+    0x9a94dd3e8cf578b9, 0x82bb74f8301958ce,
+    0xc13a148e3032d6e7, 0xe36a52363c1faf01,
+    0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1,
+    0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9,
+    0xbcb2b812db11a5de, 0x7415d448f6b6f0e7,
+    0xebdf661791d60f56, 0x111b495b3464ad21,
+    0x936b9fcebb25c995, 0xcab10dd900beec34,
+    0xb84687c269ef3bfb, 0x3d5d514f40eea742,
+    0xe65829b3046b0afa, 0x0cb4a5a3112a5112,
+    0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab,
+    0xb3f4e093db73a093, 0x59ed216765690f56,
+    0xe0f218b8d25088b8, 0x306869c13ec3532c,
+    0x8c974f7383725573, 0x1e414218c73a13fb,
+    0xafbd2350644eeacf, 0xe5d1929ef90898fa,
+    0xdbac6c247d62a583, 0xdf45f746b74abf39,
+    0x894bc396ce5da772, 0x6b8bba8c328eb783,
+    0xab9eb47c81f5114f, 0x066ea92f3f326564,
+    0xd686619ba27255a2, 0xc80a537b0efefebd,
+    0x8613fd0145877585, 0xbd06742ce95f5f36,
+    0xa798fc4196e952e7, 0x2c48113823b73704,
+    0xd17f3b51fca3a7a0, 0xf75a15862ca504c5,
+    0x82ef85133de648c4, 0x9a984d73dbe722fb,
+    0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba,
+    0xcc963fee10b7d1b3, 0x318df905079926a8,
+    0xffbbcfe994e5c61f, 0xfdf17746497f7052,
+    0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633,
+    0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0,
+    0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0,
+    0x9c1661a651213e2d, 0x06bea10ca65c084e,
+    0xc31bfa0fe5698db8, 0x486e494fcff30a62,
+    0xf3e2f893dec3f126, 0x5a89dba3c3efccfa,
+    0x986ddb5c6b3a76b7, 0xf89629465a75e01c,
+    0xbe89523386091465, 0xf6bbb397f1135823,
+    0xee2ba6c0678b597f, 0x746aa07ded582e2c,
+    0x94db483840b717ef, 0xa8c2a44eb4571cdc,
+    0xba121a4650e4ddeb, 0x92f34d62616ce413,
+    0xe896a0d7e51e1566, 0x77b020baf9c81d17,
+    0x915e2486ef32cd60, 0x0ace1474dc1d122e,
+    0xb5b5ada8aaff80b8, 0x0d819992132456ba,
+    0xe3231912d5bf60e6, 0x10e1fff697ed6c69,
+    0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1,
+    0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2,
+    0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde,
+    0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b,
+    0xad4ab7112eb3929d, 0x86c16c98d2c953c6,
+    0xd89d64d57a607744, 0xe871c7bf077ba8b7,
+    0x87625f056c7c4a8b, 0x11471cd764ad4972,
+    0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf,
+    0xd389b47879823479, 0x4aff1d108d4ec2c3,
+    0x843610cb4bf160cb, 0xcedf722a585139ba,
+    0xa54394fe1eedb8fe, 0xc2974eb4ee658828,
+    0xce947a3da6a9273e, 0x733d226229feea32,
+    0x811ccc668829b887, 0x0806357d5a3f525f,
+    0xa163ff802a3426a8, 0xca07c2dcb0cf26f7,
+    0xc9bcff6034c13052, 0xfc89b393dd02f0b5,
+    0xfc2c3f3841f17c67, 0xbbac2078d443ace2,
+    0x9d9ba7832936edc0, 0xd54b944b84aa4c0d,
+    0xc5029163f384a931, 0x0a9e795e65d4df11,
+    0xf64335bcf065d37d, 0x4d4617b5ff4a16d5,
+    0x99ea0196163fa42e, 0x504bced1bf8e4e45,
+    0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6,
+    0xf07da27a82c37088, 0x5d767327bb4e5a4c,
+    0x964e858c91ba2655, 0x3a6a07f8d510f86f,
+    0xbbe226efb628afea, 0x890489f70a55368b,
+    0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e,
+    0x92c8ae6b464fc96f, 0x3b0b8bc90012929d,
+    0xb77ada0617e3bbcb, 0x09ce6ebb40173744,
+    0xe55990879ddcaabd, 0xcc420a6a101d0515,
+    0x8f57fa54c2a9eab6, 0x9fa946824a12232d,
+    0xb32df8e9f3546564, 0x47939822dc96abf9,
+    0xdff9772470297ebd, 0x59787e2b93bc56f7,
+    0x8bfbea76c619ef36, 0x57eb4edb3c55b65a,
+    0xaefae51477a06b03, 0xede622920b6b23f1,
+    0xdab99e59958885c4, 0xe95fab368e45eced,
+    0x88b402f7fd75539b, 0x11dbcb0218ebb414,
+    0xaae103b5fcd2a881, 0xd652bdc29f26a119,
+    0xd59944a37c0752a2, 0x4be76d3346f0495f,
+    0x857fcae62d8493a5, 0x6f70a4400c562ddb,
+    0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952,
+    0xd097ad07a71f26b2, 0x7e2000a41346a7a7,
+    0x825ecc24c873782f, 0x8ed400668c0c28c8,
+    0xa2f67f2dfa90563b, 0x728900802f0f32fa,
+    0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9,
+    0xfea126b7d78186bc, 0xe2f610c84987bfa8,
+    0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9,
+    0xc6ede63fa05d3143, 0x91503d1c79720dbb,
+    0xf8a95fcf88747d94, 0x75a44c6397ce912a,
+    0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba,
+    0xc24452da229b021b, 0xfbe85badce996168,
+    0xf2d56790ab41c2a2, 0xfae27299423fb9c3,
+    0x97c560ba6b0919a5, 0xdccd879fc967d41a,
+    0xbdb6b8e905cb600f, 0x5400e987bbc1c920,
+    0xed246723473e3813, 0x290123e9aab23b68,
+    0x9436c0760c86e30b, 0xf9a0b6720aaf6521,
+    0xb94470938fa89bce, 0xf808e40e8d5b3e69,
+    0xe7958cb87392c2c2, 0xb60b1d1230b20e04,
+    0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2,
+    0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3,
+    0xe2280b6c20dd5232, 0x25c6da63c38de1b0,
+    0x8d590723948a535f, 0x579c487e5a38ad0e,
+    0xb0af48ec79ace837, 0x2d835a9df0c6d851,
+    0xdcdb1b2798182244, 0xf8e431456cf88e65,
+    0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff,
+    0xac8b2d36eed2dac5, 0xe272467e3d222f3f,
+    0xd7adf884aa879177, 0x5b0ed81dcc6abb0f,
+    0x86ccbb52ea94baea, 0x98e947129fc2b4e9,
+    0xa87fea27a539e9a5, 0x3f2398d747b36224,
+    0xd29fe4b18e88640e, 0x8eec7f0d19a03aad,
+    0x83a3eeeef9153e89, 0x1953cf68300424ac,
+    0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7,
+    0xcdb02555653131b6, 0x3792f412cb06794d,
+    0x808e17555f3ebf11, 0xe2bbd88bbee40bd0,
+    0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4,
+    0xc8de047564d20a8b, 0xf245825a5a445275,
+    0xfb158592be068d2e, 0xeed6e2f0f0d56712,
+    0x9ced737bb6c4183d, 0x55464dd69685606b,
+    0xc428d05aa4751e4c, 0xaa97e14c3c26b886,
+    0xf53304714d9265df, 0xd53dd99f4b3066a8,
+    0x993fe2c6d07b7fab, 0xe546a8038efe4029,
+    0xbf8fdb78849a5f96, 0xde98520472bdd033,
+    0xef73d256a5c0f77c, 0x963e66858f6d4440,
+    0x95a8637627989aad, 0xdde7001379a44aa8,
+    0xbb127c53b17ec159, 0x5560c018580d5d52,
+    0xe9d71b689dde71af, 0xaab8f01e6e10b4a6,
+    0x9226712162ab070d, 0xcab3961304ca70e8,
+    0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22,
+    0xe45c10c42a2b3b05, 0x8cb89a7db77c506a,
+    0x8eb98a7a9a5b04e3, 0x77f3608e92adb242,
+    0xb267ed1940f1c61c, 0x55f038b237591ed3,
+    0xdf01e85f912e37a3, 0x6b6c46dec52f6688,
+    0x8b61313bbabce2c6, 0x2323ac4b3b3da015,
+    0xae397d8aa96c1b77, 0xabec975e0a0d081a,
+    0xd9c7dced53c72255, 0x96e7bd358c904a21,
+    0x881cea14545c7575, 0x7e50d64177da2e54,
+    0xaa242499697392d2, 0xdde50bd1d5d0b9e9,
+    0xd4ad2dbfc3d07787, 0x955e4ec64b44e864,
+    0x84ec3c97da624ab4, 0xbd5af13bef0b113e,
+    0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e,
+    0xcfb11ead453994ba, 0x67de18eda5814af2,
+    0x81ceb32c4b43fcf4, 0x80eacf948770ced7,
+    0xa2425ff75e14fc31, 0xa1258379a94d028d,
+    0xcad2f7f5359a3b3e, 0x096ee45813a04330,
+    0xfd87b5f28300ca0d, 0x8bca9d6e188853fc,
+    0x9e74d1b791e07e48, 0x775ea264cf55347e,
+    0xc612062576589dda, 0x95364afe032a819e,
+    0xf79687aed3eec551, 0x3a83ddbd83f52205,
+    0x9abe14cd44753b52, 0xc4926a9672793543,
+    0xc16d9a0095928a27, 0x75b7053c0f178294,
+    0xf1c90080baf72cb1, 0x5324c68b12dd6339,
+    0x971da05074da7bee, 0xd3f6fc16ebca5e04,
+    0xbce5086492111aea, 0x88f4bb1ca6bcf585,
+    0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6,
+    0x9392ee8e921d5d07, 0x3aff322e62439fd0,
+    0xb877aa3236a4b449, 0x09befeb9fad487c3,
+    0xe69594bec44de15b, 0x4c2ebe687989a9b4,
+    0x901d7cf73ab0acd9, 0x0f9d37014bf60a11,
+    0xb424dc35095cd80f, 0x538484c19ef38c95,
+    0xe12e13424bb40e13, 0x2865a5f206b06fba,
+    0x8cbccc096f5088cb, 0xf93f87b7442e45d4,
+    0xafebff0bcb24aafe, 0xf78f69a51539d749,
+    0xdbe6fecebdedd5be, 0xb573440e5a884d1c,
+    0x89705f4136b4a597, 0x31680a88f8953031,
+    0xabcc77118461cefc, 0xfdc20d2b36ba7c3e,
+    0xd6bf94d5e57a42bc, 0x3d32907604691b4d,
+    0x8637bd05af6c69b5, 0xa63f9a49c2c1b110,
+    0xa7c5ac471b478423, 0x0fcf80dc33721d54,
+    0xd1b71758e219652b, 0xd3c36113404ea4a9,
+    0x83126e978d4fdf3b, 0x645a1cac083126ea,
+    0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4,
+    0xcccccccccccccccc, 0xcccccccccccccccd,
+    0x8000000000000000, 0x0000000000000000,
+    0xa000000000000000, 0x0000000000000000,
+    0xc800000000000000, 0x0000000000000000,
+    0xfa00000000000000, 0x0000000000000000,
+    0x9c40000000000000, 0x0000000000000000,
+    0xc350000000000000, 0x0000000000000000,
+    0xf424000000000000, 0x0000000000000000,
+    0x9896800000000000, 0x0000000000000000,
+    0xbebc200000000000, 0x0000000000000000,
+    0xee6b280000000000, 0x0000000000000000,
+    0x9502f90000000000, 0x0000000000000000,
+    0xba43b74000000000, 0x0000000000000000,
+    0xe8d4a51000000000, 0x0000000000000000,
+    0x9184e72a00000000, 0x0000000000000000,
+    0xb5e620f480000000, 0x0000000000000000,
+    0xe35fa931a0000000, 0x0000000000000000,
+    0x8e1bc9bf04000000, 0x0000000000000000,
+    0xb1a2bc2ec5000000, 0x0000000000000000,
+    0xde0b6b3a76400000, 0x0000000000000000,
+    0x8ac7230489e80000, 0x0000000000000000,
+    0xad78ebc5ac620000, 0x0000000000000000,
+    0xd8d726b7177a8000, 0x0000000000000000,
+    0x878678326eac9000, 0x0000000000000000,
+    0xa968163f0a57b400, 0x0000000000000000,
+    0xd3c21bcecceda100, 0x0000000000000000,
+    0x84595161401484a0, 0x0000000000000000,
+    0xa56fa5b99019a5c8, 0x0000000000000000,
+    0xcecb8f27f4200f3a, 0x0000000000000000,
+    0x813f3978f8940984, 0x4000000000000000,
+    0xa18f07d736b90be5, 0x5000000000000000,
+    0xc9f2c9cd04674ede, 0xa400000000000000,
+    0xfc6f7c4045812296, 0x4d00000000000000,
+    0x9dc5ada82b70b59d, 0xf020000000000000,
+    0xc5371912364ce305, 0x6c28000000000000,
+    0xf684df56c3e01bc6, 0xc732000000000000,
+    0x9a130b963a6c115c, 0x3c7f400000000000,
+    0xc097ce7bc90715b3, 0x4b9f100000000000,
+    0xf0bdc21abb48db20, 0x1e86d40000000000,
+    0x96769950b50d88f4, 0x1314448000000000,
+    0xbc143fa4e250eb31, 0x17d955a000000000,
+    0xeb194f8e1ae525fd, 0x5dcfab0800000000,
+    0x92efd1b8d0cf37be, 0x5aa1cae500000000,
+    0xb7abc627050305ad, 0xf14a3d9e40000000,
+    0xe596b7b0c643c719, 0x6d9ccd05d0000000,
+    0x8f7e32ce7bea5c6f, 0xe4820023a2000000,
+    0xb35dbf821ae4f38b, 0xdda2802c8a800000,
+    0xe0352f62a19e306e, 0xd50b2037ad200000,
+    0x8c213d9da502de45, 0x4526f422cc340000,
+    0xaf298d050e4395d6, 0x9670b12b7f410000,
+    0xdaf3f04651d47b4c, 0x3c0cdd765f114000,
+    0x88d8762bf324cd0f, 0xa5880a69fb6ac800,
+    0xab0e93b6efee0053, 0x8eea0d047a457a00,
+    0xd5d238a4abe98068, 0x72a4904598d6d880,
+    0x85a36366eb71f041, 0x47a6da2b7f864750,
+    0xa70c3c40a64e6c51, 0x999090b65f67d924,
+    0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d,
+    0x82818f1281ed449f, 0xbff8f10e7a8921a4,
+    0xa321f2d7226895c7, 0xaff72d52192b6a0d,
+    0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490,
+    0xfee50b7025c36a08, 0x02f236d04753d5b4,
+    0x9f4f2726179a2245, 0x01d762422c946590,
+    0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5,
+    0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2,
+    0x9b934c3b330c8577, 0x63cc55f49f88eb2f,
+    0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb,
+    0xf316271c7fc3908a, 0x8bef464e3945ef7a,
+    0x97edd871cfda3a56, 0x97758bf0e3cbb5ac,
+    0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317,
+    0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd,
+    0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a,
+    0xb975d6b6ee39e436, 0xb3e2fd538e122b44,
+    0xe7d34c64a9c85d44, 0x60dbbca87196b616,
+    0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd,
+    0xb51d13aea4a488dd, 0x6babab6398bdbe41,
+    0xe264589a4dcdab14, 0xc696963c7eed2dd1,
+    0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2,
+    0xb0de65388cc8ada8, 0x3b25a55f43294bcb,
+    0xdd15fe86affad912, 0x49ef0eb713f39ebe,
+    0x8a2dbf142dfcc7ab, 0x6e3569326c784337,
+    0xacb92ed9397bf996, 0x49c2c37f07965404,
+    0xd7e77a8f87daf7fb, 0xdc33745ec97be906,
+    0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3,
+    0xa8acd7c0222311bc, 0xc40832ea0d68ce0c,
+    0xd2d80db02aabd62b, 0xf50a3fa490c30190,
+    0x83c7088e1aab65db, 0x792667c6da79e0fa,
+    0xa4b8cab1a1563f52, 0x577001b891185938,
+    0xcde6fd5e09abcf26, 0xed4c0226b55e6f86,
+    0x80b05e5ac60b6178, 0x544f8158315b05b4,
+    0xa0dc75f1778e39d6, 0x696361ae3db1c721,
+    0xc913936dd571c84c, 0x03bc3a19cd1e38e9,
+    0xfb5878494ace3a5f, 0x04ab48a04065c723,
+    0x9d174b2dcec0e47b, 0x62eb0d64283f9c76,
+    0xc45d1df942711d9a, 0x3ba5d0bd324f8394,
+    0xf5746577930d6500, 0xca8f44ec7ee36479,
+    0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb,
+    0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e,
+    0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e,
+    0x95d04aee3b80ece5, 0xbba1f1d158724a12,
+    0xbb445da9ca61281f, 0x2a8a6e45ae8edc97,
+    0xea1575143cf97226, 0xf52d09d71a3293bd,
+    0x924d692ca61be758, 0x593c2626705f9c56,
+    0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c,
+    0xe498f455c38b997a, 0x0b6dfb9c0f956447,
+    0x8edf98b59a373fec, 0x4724bd4189bd5eac,
+    0xb2977ee300c50fe7, 0x58edec91ec2cb657,
+    0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed,
+    0x8b865b215899f46c, 0xbd79e0d20082ee74,
+    0xae67f1e9aec07187, 0xecd8590680a3aa11,
+    0xda01ee641a708de9, 0xe80e6f4820cc9495,
+    0x884134fe908658b2, 0x3109058d147fdcdd,
+    0xaa51823e34a7eede, 0xbd4b46f0599fd415,
+    0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a,
+    0x850fadc09923329e, 0x03e2cf6bc604ddb0,
+    0xa6539930bf6bff45, 0x84db8346b786151c,
+    0xcfe87f7cef46ff16, 0xe612641865679a63,
+    0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e,
+    0xa26da3999aef7749, 0xe3be5e330f38f09d,
+    0xcb090c8001ab551c, 0x5cadf5bfd3072cc5,
+    0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6,
+    0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa,
+    0xc646d63501a1511d, 0xb281e1fd541501b8,
+    0xf7d88bc24209a565, 0x1f225a7ca91a4226,
+    0x9ae757596946075f, 0x3375788de9b06958,
+    0xc1a12d2fc3978937, 0x0052d6b1641c83ae,
+    0xf209787bb47d6b84, 0xc0678c5dbd23a49a,
+    0x9745eb4d50ce6332, 0xf840b7ba963646e0,
+    0xbd176620a501fbff, 0xb650e5a93bc3d898,
+    0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe,
+    0x93ba47c980e98cdf, 0xc66f336c36b10137,
+    0xb8a8d9bbe123f017, 0xb80b0047445d4184,
+    0xe6d3102ad96cec1d, 0xa60dc059157491e5,
+    0x9043ea1ac7e41392, 0x87c89837ad68db2f,
+    0xb454e4a179dd1877, 0x29babe4598c311fb,
+    0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a,
+    0x8ce2529e2734bb1d, 0x1899e4a65f58660c,
+    0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f,
+    0xdc21a1171d42645d, 0x76707543f4fa1f73,
+    0x899504ae72497eba, 0x6a06494a791c53a8,
+    0xabfa45da0edbde69, 0x0487db9d17636892,
+    0xd6f8d7509292d603, 0x45a9d2845d3c42b6,
+    0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2,
+    0xa7f26836f282b732, 0x8e6cac7768d7141e,
+    0xd1ef0244af2364ff, 0x3207d795430cd926,
+    0x8335616aed761f1f, 0x7f44e6bd49e807b8,
+    0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6,
+    0xcd036837130890a1, 0x36dba887c37a8c0f,
+    0x802221226be55a64, 0xc2494954da2c9789,
+    0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c,
+    0xc83553c5c8965d3d, 0x6f92829494e5acc7,
+    0xfa42a8b73abbf48c, 0xcb772339ba1f17f9,
+    0x9c69a97284b578d7, 0xff2a760414536efb,
+    0xc38413cf25e2d70d, 0xfef5138519684aba,
+    0xf46518c2ef5b8cd1, 0x7eb258665fc25d69,
+    0x98bf2f79d5993802, 0xef2f773ffbd97a61,
+    0xbeeefb584aff8603, 0xaafb550ffacfd8fa,
+    0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38,
+    0x952ab45cfa97a0b2, 0xdd945a747bf26183,
+    0xba756174393d88df, 0x94f971119aeef9e4,
+    0xe912b9d1478ceb17, 0x7a37cd5601aab85d,
+    0x91abb422ccb812ee, 0xac62e055c10ab33a,
+    0xb616a12b7fe617aa, 0x577b986b314d6009,
+    0xe39c49765fdf9d94, 0xed5a7e85fda0b80b,
+    0x8e41ade9fbebc27d, 0x14588f13be847307,
+    0xb1d219647ae6b31c, 0x596eb2d8ae258fc8,
+    0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb,
+    0x8aec23d680043bee, 0x25de7bb9480d5854,
+    0xada72ccc20054ae9, 0xaf561aa79a10ae6a,
+    0xd910f7ff28069da4, 0x1b2ba1518094da04,
+    0x87aa9aff79042286, 0x90fb44d2f05d0842,
+    0xa99541bf57452b28, 0x353a1607ac744a53,
+    0xd3fa922f2d1675f2, 0x42889b8997915ce8,
+    0x847c9b5d7c2e09b7, 0x69956135febada11,
+    0xa59bc234db398c25, 0x43fab9837e699095,
+    0xcf02b2c21207ef2e, 0x94f967e45e03f4bb,
+    0x8161afb94b44f57d, 0x1d1be0eebac278f5,
+    0xa1ba1ba79e1632dc, 0x6462d92a69731732,
+    0xca28a291859bbf93, 0x7d7b8f7503cfdcfe,
+    0xfcb2cb35e702af78, 0x5cda735244c3d43e,
+    0x9defbf01b061adab, 0x3a0888136afa64a7,
+    0xc56baec21c7a1916, 0x088aaa1845b8fdd0,
+    0xf6c69a72a3989f5b, 0x8aad549e57273d45,
+    0x9a3c2087a63f6399, 0x36ac54e2f678864b,
+    0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd,
+    0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5,
+    0x969eb7c47859e743, 0x9f644ae5a4b1b325,
+    0xbc4665b596706114, 0x873d5d9f0dde1fee,
+    0xeb57ff22fc0c7959, 0xa90cb506d155a7ea,
+    0x9316ff75dd87cbd8, 0x09a7f12442d588f2,
+    0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f,
+    0xe5d3ef282a242e81, 0x8f1668c8a86da5fa,
+    0x8fa475791a569d10, 0xf96e017d694487bc,
+    0xb38d92d760ec4455, 0x37c981dcc395a9ac,
+    0xe070f78d3927556a, 0x85bbe253f47b1417,
+    0x8c469ab843b89562, 0x93956d7478ccec8e,
+    0xaf58416654a6babb, 0x387ac8d1970027b2,
+    0xdb2e51bfe9d0696a, 0x06997b05fcc0319e,
+    0x88fcf317f22241e2, 0x441fece3bdf81f03,
+    0xab3c2fddeeaad25a, 0xd527e81cad7626c3,
+    0xd60b3bd56a5586f1, 0x8a71e223d8d3b074,
+    0x85c7056562757456, 0xf6872d5667844e49,
+    0xa738c6bebb12d16c, 0xb428f8ac016561db,
+    0xd106f86e69d785c7, 0xe13336d701beba52,
+    0x82a45b450226b39c, 0xecc0024661173473,
+    0xa34d721642b06084, 0x27f002d7f95d0190,
+    0xcc20ce9bd35c78a5, 0x31ec038df7b441f4,
+    0xff290242c83396ce, 0x7e67047175a15271,
+    0x9f79a169bd203e41, 0x0f0062c6e984d386,
+    0xc75809c42c684dd1, 0x52c07b78a3e60868,
+    0xf92e0c3537826145, 0xa7709a56ccdf8a82,
+    0x9bbcc7a142b17ccb, 0x88a66076400bb691,
+    0xc2abf989935ddbfe, 0x6acff893d00ea435,
+    0xf356f7ebf83552fe, 0x0583f6b8c4124d43,
+    0x98165af37b2153de, 0xc3727a337a8b704a,
+    0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c,
+    0xeda2ee1c7064130c, 0x1162def06f79df73,
+    0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8,
+    0xb9a74a0637ce2ee1, 0x6d953e2bd7173692,
+    0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437,
+    0x910ab1d4db9914a0, 0x1d9c9892400a22a2,
+    0xb54d5e4a127f59c8, 0x2503beb6d00cab4b,
+    0xe2a0b5dc971f303a, 0x2e44ae64840fd61d,
+    0x8da471a9de737e24, 0x5ceaecfed289e5d2,
+    0xb10d8e1456105dad, 0x7425a83e872c5f47,
+    0xdd50f1996b947518, 0xd12f124e28f77719,
+    0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f,
+    0xace73cbfdc0bfb7b, 0x636cc64d1001550b,
+    0xd8210befd30efa5a, 0x3c47f7e05401aa4e,
+    0x8714a775e3e95c78, 0x65acfaec34810a71,
+    0xa8d9d1535ce3b396, 0x7f1839a741a14d0d,
+    0xd31045a8341ca07c, 0x1ede48111209a050,
+    0x83ea2b892091e44d, 0x934aed0aab460432,
+    0xa4e4b66b68b65d60, 0xf81da84d5617853f,
+    0xce1de40642e3f4b9, 0x36251260ab9d668e,
+    0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019,
+    0xa1075a24e4421730, 0xb24cf65b8612f81f,
+    0xc94930ae1d529cfc, 0xdee033f26797b627,
+    0xfb9b7cd9a4a7443c, 0x169840ef017da3b1,
+    0x9d412e0806e88aa5, 0x8e1f289560ee864e,
+    0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2,
+    0xf5b5d7ec8acb58a2, 0xae10af696774b1db,
+    0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29,
+    0xbff610b0cc6edd3f, 0x17fd090a58d32af3,
+    0xeff394dcff8a948e, 0xddfc4b4cef07f5b0,
+    0x95f83d0a1fb69cd9, 0x4abdaf101564f98e,
+    0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1,
+    0xea53df5fd18d5513, 0x84c86189216dc5ed,
+    0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4,
+    0xb7118682dbb66a77, 0x3fbc8c33221dc2a1,
+    0xe4d5e82392a40515, 0x0fabaf3feaa5334a,
+    0x8f05b1163ba6832d, 0x29cb4d87f2a7400e,
+    0xb2c71d5bca9023f8, 0x743e20e9ef511012,
+    0xdf78e4b2bd342cf6, 0x914da9246b255416,
+    0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e,
+    0xae9672aba3d0c320, 0xa184ac2473b529b1,
+    0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e,
+    0x8865899617fb1871, 0x7e2fa67c7a658892,
+    0xaa7eebfb9df9de8d, 0xddbb901b98feeab7,
+    0xd51ea6fa85785631, 0x552a74227f3ea565,
+    0x8533285c936b35de, 0xd53a88958f87275f,
+    0xa67ff273b8460356, 0x8a892abaf368f137,
+    0xd01fef10a657842c, 0x2d2b7569b0432d85,
+    0x8213f56a67f6b29b, 0x9c3b29620e29fc73,
+    0xa298f2c501f45f42, 0x8349f3ba91b47b8f,
+    0xcb3f2f7642717713, 0x241c70a936219a73,
+    0xfe0efb53d30dd4d7, 0xed238cd383aa0110,
+    0x9ec95d1463e8a506, 0xf4363804324a40aa,
+    0xc67bb4597ce2ce48, 0xb143c6053edcd0d5,
+    0xf81aa16fdc1b81da, 0xdd94b7868e94050a,
+    0x9b10a4e5e9913128, 0xca7cf2b4191c8326,
+    0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0,
+    0xf24a01a73cf2dccf, 0xbc633b39673c8cec,
+    0x976e41088617ca01, 0xd5be0503e085d813,
+    0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18,
+    0xec9c459d51852ba2, 0xddf8e7d60ed1219e,
+    0x93e1ab8252f33b45, 0xcabb90e5c942b503,
+    0xb8da1662e7b00a17, 0x3d6a751f3b936243,
+    0xe7109bfba19c0c9d, 0x0cc512670a783ad4,
+    0x906a617d450187e2, 0x27fb2b80668b24c5,
+    0xb484f9dc9641e9da, 0xb1f9f660802dedf6,
+    0xe1a63853bbd26451, 0x5e7873f8a0396973,
+    0x8d07e33455637eb2, 0xdb0b487b6423e1e8,
+    0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62,
+    0xdc5c5301c56b75f7, 0x7641a140cc7810fb,
+    0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d,
+    0xac2820d9623bf429, 0x546345fa9fbdcd44,
+    0xd732290fbacaf133, 0xa97c177947ad4095,
+    0x867f59a9d4bed6c0, 0x49ed8eabcccc485d,
+    0xa81f301449ee8c70, 0x5c68f256bfff5a74,
+    0xd226fc195c6a2f8c, 0x73832eec6fff3111,
+    0x83585d8fd9c25db7, 0xc831fd53c5ff7eab,
+    0xa42e74f3d032f525, 0xba3e7ca8b77f5e55,
+    0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb,
+    0x80444b5e7aa7cf85, 0x7980d163cf5b81b3,
+    0xa0555e361951c366, 0xd7e105bcc332621f,
+    0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7,
+    0xfa856334878fc150, 0xb14f98f6f0feb951,
+    0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3,
+    0xc3b8358109e84f07, 0x0a862f80ec4700c8,
+    0xf4a642e14c6262c8, 0xcd27bb612758c0fa,
+    0x98e7e9cccfbd7dbd, 0x8038d51cb897789c,
+    0xbf21e44003acdd2c, 0xe0470a63e6bd56c3,
+    0xeeea5d5004981478, 0x1858ccfce06cac74,
+    0x95527a5202df0ccb, 0x0f37801e0c43ebc8,
+    0xbaa718e68396cffd, 0xd30560258f54e6ba,
+    0xe950df20247c83fd, 0x47c6b82ef32a2069,
+    0x91d28b7416cdd27e, 0x4cdc331d57fa5441,
+    0xb6472e511c81471d, 0xe0133fe4adf8e952,
+    0xe3d8f9e563a198e5, 0x58180fddd97723a6,
+    0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648,
+};
+
+// bits of the double closest to mantissa * 10^exponent, without the sign,
+// see Lemire's "Number Parsing at a Gigabyte per Second"
+unsigned long long json_eisel_lemire(unsigned long long mantissa, long long exponent)
+{
+    if (mantissa == 0 || exponent < -342)
+        return 0;
+    if (exponent > 308)
+        return 0x7FFULL << 52;
+    int leading_zeros = json_clz(mantissa);
+    mantissa <<= leading_zeros;
+    const unsigned long long *power = json_powers_of_five + 2 * (exponent + 342);
+    unsigned long long high;
+    unsigned long long low = json_mul128(mantissa, power[0], &high);
+    // the low 9 bits only matter for rounding, they need the second word of
+    // the power when they could carry
+    if ((high & 0x1FF) == 0x1FF)
+    {
+        unsigned long long second_high;
+        json_mul128(mantissa, power[1], &second_high);
+        low += second_high;
+        high += second_high > low;
+    }
+    int upper_bit = (int)(high >> 63);
+    int shift = upper_bit + 9;
+    unsigned long long bits = high >> shift;
+    // floor(log2(10^exponent)) + 63, biased by 1023
+    long long power2 = ((217706 * exponent) >> 16) + 63 + upper_bit - leading_zeros + 1023;
+    if (power2 <= 0)
+    {
+        // subnormal
+        if (-power2 + 1 >= 64)
+            return 0;
+        bits >>= -power2 + 1;
+        bits += bits & 1;
+        bits >>= 1;
+        return bits;
+    }
+    // exactly halfway between two doubles, round to even
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (bits & 3) == 1 && (bits << shift) == high)
+        bits &= ~1ULL;
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >= (2ULL << 52))
+    {
+        bits = 1ULL << 52;
+        power2++;
+    }
+    bits &= ~(1ULL << 52);
+    if (power2 >= 0x7FF)
+        return 0x7FFULL << 52;
+    return bits | (unsigned long long)power2 << 52;
+}
+
+// `source` is the text of the number, only read when the fast paths can't
+// tell how to round
+double json_number_to_double(const JNumber *number, const char *source, jsize_t length)
+{
+    double result;
+    if (!number->truncated && number->mantissa <= 1ULL << 53 && number->exponent >= -22 && number->exponent <= 22)
+    {
+        // both the mantissa and the power of ten are exact doubles
+        result = (double)number->mantissa;
+        if (number->exponent < 0)
+            result /= json_powers_of_ten[-number->exponent];
+        else
+            result *= json_powers_of_ten[number->exponent];
+        return number->negative ? -result : result;
+    }
+    unsigned long long bits = json_eisel_lemire(number->mantissa, number->exponent);
+    // the dropped digits put the number between mantissa and mantissa + 1
+    if (number->truncated && bits != json_eisel_lemire(number->mantissa + 1, number->exponent))
+    {
+#ifndef NOSTDLIB
+        // strtod reads the decimal point of the locale, not '.'
+        const char *point = localeconv()->decimal_point;
+        jsize_t point_length = 0;
+        while (point[point_length])
+            point_length++;
+        char buffer[128];
+        char *copy = length + point_length < sizeof(buffer) ? buffer : (char *)malloc(length + point_length);
+        if (copy)
         {
-            parser->pos++;
-            goto parse_pair;
+            jsize_t size = 0;
+            for (jsize_t i = 0; i < length; i++)
+            {
+                if (source[i] == '.')
+                {
+                    json_memcpy(copy + size, point, point_length);
+                    size += point_length;
+                }
+                else
+                    copy[size++] = source[i];
+            }
+            copy[size] = '\0';
+            result = strtod(copy, 0);
+            if (copy != buffer)
+                free(copy);
+            return result;
         }
-    } // parse_pair
+#else
+        (void)source;
+        (void)length;
+#endif // NOSTDLIB
+    }
+    bits |= (unsigned long long)number->negative << 63;
+    json_memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// the value of a scanned number, the text of bignums is left in `source`
+JValue json_number_value(const JNumber *number, const char *source, jsize_t length)
+{
+    JValue value;
+    if (!number->integer)
     {
-        int match = json_match_char(parser, '}');
-        if (match == JSON_UNEXPECTED_EOF)
-            return json_unexpected_eof(parser->pos);
-        if (match == JSON_PARSE_ERROR)
-        {
-            JValue error_value;
-            error_value.type = JSON_ERROR;
-            error_value.error = JSON_PARSE_ERROR;
+        value.type = JSON_DOUBLE;
+        value.real = json_number_to_double(number, source, length);
+    }
+    else if (number->exponent == 0 && number->mantissa <= 9223372036854775807ULL + number->negative)
+    {
+        value.type = JSON_NUMBER;
+        // LLONG_MIN has no positive counterpart
+        if (number->negative && number->mantissa != 0)
+            value.number = -(long long)(number->mantissa - 1) - 1;
+        else
+            value.number = (long long)number->mantissa;
+    }
+    else if (number->exponent == 0 && !number->negative)
+    {
+        value.type = JSON_UNSIGNED;
+        value.unsigned_number = number->mantissa;
+    }
+    else
+    {
+        // keep the text, converting it would lose digits
+        value.type = JSON_BIGNUM;
+        value.string.data = (char *)source;
+        value.string.length = length;
+    }
+    return value;
+}
+
+JValue json_parse_number(JParser *parser)
+{
+    JNumber number;
+    jsize_t start = parser->pos;
+    jsize_t end;
+    int result;
+    if (parser->flags & JSON_LAZY_NUMBERS)
+        result = json_validate_number(parser->input, start, parser->length, &end);
+    else
+        result = json_scan_number(parser->input, start, parser->length, &number, &end);
+    char c = result == 1 && end < parser->length ? parser->input[end] : '\0';
+    if (result != 1 || !(json_whitespace_char(c) || c == ',' || c == '}' || c == ']' || c == '\0'))
+    {
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = JSON_PARSE_ERROR;
 #if !defined(NDEBUG)
-            fprintf(stderr, "expected '%c' found '%c' at %llu\n", '}',
-                    parser->input[parser->pos - 1], parser->pos - 1);
+        fprintf(stderr, "couldn't parse a number at %llu\n", start + 1);
 #endif // NDEBUG
-            return error_value;
-        }
+        return value;
+    }
+    parser->pos = end;
+    if (!json_length_fits(end - start))
+        return json_too_long(end);
+    JValue value;
+    if (parser->flags & JSON_LAZY_NUMBERS)
+    {
+        value.type = JSON_RAW_NUMBER;
+        value.string.data = (char *)parser->input + start;
+        value.string.length = end - start;
+        return value;
+    }
+    value = json_number_value(&number, parser->input + start, end - start);
+    if (value.type == JSON_BIGNUM && !(parser->flags & (JSON_ZERO_COPY | JSON_INSITU)))
+    {
+        value.string.data = (char *)json_alloc(parser, (value.string.length + 1 + 7) & ~(jsize_t)7);
+        if (value.string.data == 0)
+        {
+            value.type = JSON_ERROR;
+            value.error = JSON_MEMORY_ERROR;
+            return value;
+        }
+        json_memcpy(value.string.data, parser->input + start, value.string.length);
+        value.string.data[value.string.length] = '\0';
+    }
+    return value;
+}
+
+// replaces a JSON_RAW_NUMBER with its converted value, so it is only
+// converted once, bignums keep pointing at the input
+int json_convert_number(JValue *value)
+{
+    if (value->type != JSON_RAW_NUMBER)
+        return 1;
+    JNumber number;
+    jsize_t end;
+    if (json_scan_number(value->string.data, 0, value->string.length, &number, &end) != 1 ||
+        end != value->string.length)
+        return JSON_PARSE_ERROR;
+    *value = json_number_value(&number, value->string.data, value->string.length);
+    return 1;
+}
+
+int json_as_int(JValue *value, long long *result)
+{
+    int converted = json_convert_number(value);
+    if (converted != 1)
+        return converted;
+    switch (value->type)
+    {
+    case JSON_NUMBER:
+        *result = value->number;
+        return 1;
+    case JSON_UNSIGNED:
+    case JSON_BIGNUM:
+        return JSON_RANGE_ERROR;
+    default:
+        return JSON_TYPE_ERROR;
+    }
+}
+
+int json_as_uint(JValue *value, unsigned long long *result)
+{
+    int converted = json_convert_number(value);
+    if (converted != 1)
+        return converted;
+    switch (value->type)
+    {
+    case JSON_NUMBER:
+        if (value->number < 0)
+            return JSON_RANGE_ERROR;
+        *result = (unsigned long long)value->number;
+        return 1;
+    case JSON_UNSIGNED:
+        *result = value->unsigned_number;
+        return 1;
+    case JSON_BIGNUM:
+        return JSON_RANGE_ERROR;
+    default:
+        return JSON_TYPE_ERROR;
+    }
+}
+
+int json_as_double(JValue *value, double *result)
+{
+    int converted = json_convert_number(value);
+    if (converted != 1)
+        return converted;
+    switch (value->type)
+    {
+    case JSON_NUMBER:
+        *result = (double)value->number;
+        return 1;
+    case JSON_UNSIGNED:
+        *result = (double)value->unsigned_number;
+        return 1;
+    case JSON_DOUBLE:
+        *result = value->real;
+        return 1;
+    case JSON_BIGNUM:
+        {
+            JNumber number;
+            jsize_t end;
+            json_scan_number(value->string.data, 0, value->string.length, &number, &end);
+            *result = json_number_to_double(&number, value->string.data, value->string.length);
+            return 1;
+        }
+    default:
+        return JSON_TYPE_ERROR;
+    }
+}
+
+JValue json_parse_boolean(JParser *parser, int bool_value, const char *bool_string, jsize_t bool_string_length)
+{
+    if (parser->pos + bool_string_length <= parser->length &&
+        json_memcmp(parser->input + parser->pos, bool_string, bool_string_length) == 0)
+    {
+        JValue value;
+        value.type = JSON_BOOL;
+        value.boolean = bool_value;
+        parser->pos += bool_string_length;
+        return value;
+    }
+    JValue value;
+    value.type = JSON_ERROR;
+    value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+    fprintf(stderr, "failed to parse %s\n", bool_string);
+#endif // NDEBUG
+    return value;
+}
+
+JValue json_parse_null(JParser *parser)
+{
+    if (parser->pos + 4 <= parser->length && json_memcmp(parser->input + parser->pos, "null", 4) == 0)
+    {
+        JValue value;
+        value.type = JSON_NULL;
+        value.null = 0;
+        parser->pos += 4;
+        return value;
+    }
+    JValue value;
+    value.type = JSON_ERROR;
+    value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+    fprintf(stderr, "failed to parse null\n");
+#endif // NDEBUG
+    return value;
+}
+
+JValue json_parse_array(JParser *parser)
+{
+    parser->pos++;
+    if (!json_skip_whitespaces(parser))
+        return json_unexpected_eof(parser->pos);
+    JValue value;
+    value.type = JSON_ARRAY;
+    if (parser->input[parser->pos] == ']')
+    {
+        value.array.data = 0;
+        value.array.length = 0;
+        parser->pos++;
+        return value;
+    }
+    jsize_t scratch_start = parser->scratch_size;
+    for (;;)
+    {
+        if (!json_skip_whitespaces(parser))
+            return json_unexpected_eof(parser->pos);
+        JValue array_value = json_parse_value(parser);
+        if (array_value.type == JSON_ERROR)
+            return array_value;
+        JValue *slot = (JValue *)json_scratch_push(parser, sizeof(JValue));
+        if (slot == 0)
+        {
+            JValue value;
+            value.type = JSON_ERROR;
+            value.error = JSON_MEMORY_ERROR;
+            return value;
+        }
+        *slot = array_value;
+        if (!json_skip_whitespaces(parser))
+            return json_unexpected_eof(parser->pos);
+        char c = parser->input[parser->pos++];
+        if (c == ']')
+            break;
+        if (c != ',')
+        {
+            JValue value;
+            value.type = JSON_ERROR;
+            value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+            fprintf(stderr, "expected ',' or ']' found '%c' at %llu\n", c, parser->pos - 1);
+#endif // NDEBUG
+            return value;
+        }
+    }
+    jsize_t array_values_count = (parser->scratch_size - scratch_start) / sizeof(JValue);
+    if (!json_length_fits(array_values_count))
+        return json_too_long(parser->pos);
+    JValue *array_values = (JValue *)json_alloc(parser, sizeof(JValue) * array_values_count);
+    if (array_values == 0)
+    {
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = JSON_MEMORY_ERROR;
+        return value;
+    }
+    json_memcpy(array_values, parser->scratch + scratch_start, sizeof(JValue) * array_values_count);
+    parser->scratch_size = scratch_start;
+    value.array.data = array_values;
+    value.array.length = array_values_count;
+    return value;
+}
+
+JValue json_unexpected_eof(jsize_t pos)
+{
+    JValue value;
+    value.type = JSON_ERROR;
+    value.error = JSON_UNEXPECTED_EOF;
+#if !defined(NDEBUG)
+    fprintf(stderr, "unexpected end of file at %llu\n", pos);
+#endif // NDEBUG
+    return value;
+}
+
+// strings and containers longer than jlength_t holds
+int json_length_fits(jsize_t length)
+{
+#if defined(JP_COMPACT)
+    return length <= 0xFFFFFFFFULL;
+#else
+    (void)length;
+    return 1;
+#endif // JP_COMPACT
+}
+
+JValue json_too_long(jsize_t pos)
+{
+    JValue value;
+    value.type = JSON_ERROR;
+    value.error = JSON_RANGE_ERROR;
+#if !defined(NDEBUG)
+    fprintf(stderr, "value before %llu is too long for JP_COMPACT\n", pos);
+#else
+    (void)pos;
+#endif // NDEBUG
+    return value;
+}
+
+JValue json_parse_value(JParser *parser)
+{
+    switch (json_peek(parser))
+    {
+    case '{':
+        return json_parse_object(parser);
+    case '[':
+        return json_parse_array(parser);
+    case '"':
+        return json_parse_string(parser);
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        return json_parse_number(parser);
+    case 't':
+        return json_parse_boolean(parser, 1, "true", 4);
+    case 'f':
+        return json_parse_boolean(parser, 0, "false", 5);
+    case 'n':
+        return json_parse_null(parser);
+    default:
+        {
+            JValue value;
+            value.type = JSON_ERROR;
+            value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+            fprintf(stderr, "unknown char %c at %llu\n", json_peek(parser), parser->pos);
+#endif // NDEBUG
+            return value;
+        }
+    }
+}
+
+JValue json_parse_object(JParser *parser)
+{
+    int match = json_match_char(parser, '{');
+    if (match == JSON_UNEXPECTED_EOF)
+        return json_unexpected_eof(parser->pos);
+    if (match == JSON_PARSE_ERROR)
+    {
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+        fprintf(stderr, "expected '%c' found '%c' at %llu\n", '{',
+                parser->input[parser->pos - 1], parser->pos - 1);
+#endif // NDEBUG
+        return value;
+    }
+
+    JValue value;
+    value.type = JSON_OBJECT;
+    value.object.data = 0;
+    value.object.length = 0;
+
+    jsize_t scratch_start = parser->scratch_size;
+
+parse_pair:
+    {
+        {
+            int match = json_match_char(parser, '"');
+            if (match == JSON_UNEXPECTED_EOF)
+                return json_unexpected_eof(parser->pos);
+            if (match == JSON_PARSE_ERROR)
+            {
+                if (parser->input[parser->pos - 1] == '}' && value.object.length == 0)
+                    return value;
+                JValue value;
+                value.type = JSON_ERROR;
+                value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected '%c' found '%c' at %llu\n", '"',
+                        parser->input[parser->pos - 1], parser->pos - 1);
+#endif // NDEBUG
+                return value;
+            }
+        }
+
+        parser->pos--;
+
+        JValue key_value = json_parse_string(parser);
+        if (key_value.type == JSON_ERROR)
+            return key_value;
+
+        char *key = key_value.string.data ? key_value.string.data : (char *)"";
+        jsize_t key_length = key_value.string.length;
+
+        {
+            int match = json_match_char(parser, ':');
+            if (match == JSON_UNEXPECTED_EOF)
+                return json_unexpected_eof(parser->pos);
+            if (match == JSON_PARSE_ERROR)
+            {
+                JValue error_value;
+                error_value.type = JSON_ERROR;
+                error_value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected '%c' found '%c' at %llu\n", ':',
+                        parser->input[parser->pos - 1], parser->pos - 1);
+#endif // NDEBUG
+                return error_value;
+            }
+        }
+        if (!json_skip_whitespaces(parser))
+            return json_unexpected_eof(parser->pos);
+
+        JValue object_value = json_parse_value(parser);
+        if (object_value.type == JSON_ERROR)
+            return object_value;
+
+        JPair *pair = (JPair *)json_scratch_push(parser, sizeof(JPair));
+        if (pair == 0)
+        {
+            JValue error_value;
+            error_value.type = JSON_ERROR;
+            error_value.error = JSON_MEMORY_ERROR;
+            return error_value;
+        }
+        pair->key = key;
+        pair->key_length = key_length;
+        pair->value = object_value;
+        value.object.length++;
+
+        if (!json_skip_whitespaces(parser))
+            return json_unexpected_eof(parser->pos);
+
+        if (parser->input[parser->pos] == ',')
+        {
+            parser->pos++;
+            goto parse_pair;
+        }
+    } // parse_pair
+    {
+        int match = json_match_char(parser, '}');
+        if (match == JSON_UNEXPECTED_EOF)
+            return json_unexpected_eof(parser->pos);
+        if (match == JSON_PARSE_ERROR)
+        {
+            JValue error_value;
+            error_value.type = JSON_ERROR;
+            error_value.error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+            fprintf(stderr, "expected '%c' found '%c' at %llu\n", '}',
+                    parser->input[parser->pos - 1], parser->pos - 1);
+#endif // NDEBUG
+            return error_value;
+        }
+    }
+
+    // the count in the value wraps in JP_COMPACT
+    if (!json_length_fits((parser->scratch_size - scratch_start) / sizeof(JPair)))
+        return json_too_long(parser->pos);
+    JPair *pairs = (JPair *)json_alloc(parser, sizeof(JPair) * value.object.length);
+    if (pairs == 0)
+    {
+        JValue error_value;
+        error_value.type = JSON_ERROR;
+        error_value.error = JSON_MEMORY_ERROR;
+        return error_value;
+    }
+    json_memcpy(pairs, parser->scratch + scratch_start, sizeof(JPair) * value.object.length);
+    parser->scratch_size = scratch_start;
+    value.object.data = pairs;
+    return value;
+}
+
+int json_skip_string(JParser *parser)
+{
+    parser->pos++;
+    for (;;)
+    {
+        parser->pos = json_scan_string(parser->input, parser->pos, parser->length);
+        char c = json_peek(parser);
+        if (c == '"')
+        {
+            parser->pos++;
+            return 1;
+        }
+        if (c == '\0')
+            return JSON_UNEXPECTED_EOF;
+        if (c != '\\')
+            return JSON_PARSE_ERROR;
+        parser->pos++;
+        if (json_peek(parser) == '\0')
+            return JSON_UNEXPECTED_EOF;
+        parser->pos++;
+    }
+}
+
+int json_popcount(unsigned long long mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mask);
+#else
+    int count = 0;
+    for (; mask; mask &= mask - 1)
+        count++;
+    return count;
+#endif
+}
+
+#if defined(JP_SSE2)
+JP_NO_SANITIZE_ADDRESS void json_classify_brackets(const unsigned char *block, JBrackets *masks)
+{
+    masks->quote = masks->backslash = masks->open = masks->close = masks->zero = 0;
+#if defined(JP_AVX2)
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 32)
+    {
+        __m256i chunk = _mm256_load_si256((const __m256i *)(block + i));
+        masks->quote |= json_avx2_eq(chunk, '"') << i;
+        masks->backslash |= json_avx2_eq(chunk, '\\') << i;
+        masks->open |= (json_avx2_eq(chunk, '{') | json_avx2_eq(chunk, '[')) << i;
+        masks->close |= (json_avx2_eq(chunk, '}') | json_avx2_eq(chunk, ']')) << i;
+        masks->zero |= json_avx2_eq(chunk, '\0') << i;
+    }
+#else
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 16)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i *)(block + i));
+        masks->quote |= json_sse2_eq(chunk, '"') << i;
+        masks->backslash |= json_sse2_eq(chunk, '\\') << i;
+        masks->open |= (json_sse2_eq(chunk, '{') | json_sse2_eq(chunk, '[')) << i;
+        masks->close |= (json_sse2_eq(chunk, '}') | json_sse2_eq(chunk, ']')) << i;
+        masks->zero |= json_sse2_eq(chunk, '\0') << i;
+    }
+#endif // JP_AVX2
+}
+#endif // JP_SSE2
+
+// skips an object or array, only checking that strings end and brackets
+// balance, the SIMD version reads 64 bytes at a time and passes blocks whose
+// closing brackets can't bring the depth to zero with a few popcounts
+int json_skip_container(JParser *parser)
+{
+#if defined(JP_SSE2)
+    const unsigned char *input = (const unsigned char *)parser->input;
+    const unsigned char *block = (const unsigned char *)((JP_UINTPTR)(input + parser->pos) & ~(JP_UINTPTR)(JSON_BLOCK_SIZE - 1));
+    unsigned long long prev_escaped = 0;
+    unsigned long long prev_in_string = 0;
+    jsize_t depth = 0;
+    for (;; block += JSON_BLOCK_SIZE)
+    {
+        JBrackets masks;
+        json_classify_brackets(block, &masks);
+        unsigned long long valid = ~0ULL;
+        if (block < input + parser->pos)
+            valid <<= input + parser->pos - block;
+        if (parser->length != JSON_NUL_TERMINATED)
+        {
+            jsize_t available = block < input ? parser->length + (jsize_t)(input - block) : parser->length - (jsize_t)(block - input);
+            if (available < JSON_BLOCK_SIZE)
+            {
+                // the end of the input works like a terminator
+                masks.zero |= 1ULL << available;
+            }
+        }
+        unsigned long long end = masks.zero & valid;
+        if (end)
+            valid &= (end & (0ULL - end)) - 1;
+        unsigned long long escaped = json_escaped_mask(masks.backslash & valid, &prev_escaped);
+        unsigned long long in_string = json_prefix_xor(masks.quote & valid & ~escaped) ^ prev_in_string;
+        prev_in_string = 0ULL - (in_string >> 63);
+        unsigned long long open = masks.open & valid & ~in_string;
+        unsigned long long close = masks.close & valid & ~in_string;
+        if (!end && (jsize_t)json_popcount(close) < depth)
+        {
+            depth += json_popcount(open) - json_popcount(close);
+            continue;
+        }
+        for (unsigned long long brackets = open | close; brackets; brackets &= brackets - 1)
+        {
+            unsigned long long bit = brackets & (0ULL - brackets);
+            if (open & bit)
+                depth++;
+            else if (--depth == 0)
+            {
+                parser->pos = (jsize_t)(block + json_ctz(bit) - input) + 1;
+                return 1;
+            }
+        }
+        if (end)
+        {
+            parser->pos = (jsize_t)(block + json_ctz(end) - input);
+            return JSON_UNEXPECTED_EOF;
+        }
+    }
+#else
+    jsize_t depth = 0;
+    for (;;)
+    {
+        char c = json_peek(parser);
+        if (c == '\0')
+            return JSON_UNEXPECTED_EOF;
+        parser->pos++;
+        if (c == '"')
+        {
+            while ((c = json_peek(parser)) != '"')
+            {
+                if (c == '\0')
+                    return JSON_UNEXPECTED_EOF;
+                parser->pos++;
+                if (c == '\\')
+                {
+                    if (json_peek(parser) == '\0')
+                        return JSON_UNEXPECTED_EOF;
+                    parser->pos++;
+                }
+            }
+            parser->pos++;
+        }
+        else if (c == '{' || c == '[')
+            depth++;
+        else if ((c == '}' || c == ']') && --depth == 0)
+            return 1;
+    }
+#endif // JP_SSE2
+}
+
+// moves past the value at the current position without building it,
+// containers are only checked for terminated strings and balanced brackets
+int json_skip_value(JParser *parser)
+{
+    char c = json_peek(parser);
+    switch (c)
+    {
+    case '"':
+        return json_skip_string(parser);
+    case '{':
+    case '[':
+        return json_skip_container(parser);
+    case 't':
+        return json_parse_boolean(parser, 1, "true", 4).type == JSON_ERROR ? JSON_PARSE_ERROR : 1;
+    case 'f':
+        return json_parse_boolean(parser, 0, "false", 5).type == JSON_ERROR ? JSON_PARSE_ERROR : 1;
+    case 'n':
+        return json_parse_null(parser).type == JSON_ERROR ? JSON_PARSE_ERROR : 1;
+    case '\0':
+        return JSON_UNEXPECTED_EOF;
+    default:
+        {
+            jsize_t end;
+            if (json_validate_number(parser->input, parser->pos, parser->length, &end) != 1)
+                return JSON_PARSE_ERROR;
+            parser->pos = end;
+            return 1;
+        }
+    }
+}
+
+// nothing is parsed until the cursor is read, the input has to outlive
+// the cursor and the strings read with it, the arena the values read with it,
+// json_arena_free releases them
+JCursor json_cursor_begin(JArena *arena, const char *input, jsize_t length)
+{
+    JParser parser = json_init_parser(0, input);
+    parser.length = length;
+    if (!json_skip_whitespaces(&parser))
+        return json_cursor_error(JSON_UNEXPECTED_EOF);
+    JCursor cursor;
+    cursor.arena = arena;
+    cursor.input = input;
+    cursor.length = length;
+    cursor.pos = parser.pos;
+    cursor.last = 0;
+    cursor.error = 1;
+    return cursor;
+}
+
+JCursor json_cursor_error(JCode error)
+{
+    JCursor cursor;
+    cursor.arena = 0;
+    cursor.input = 0;
+    cursor.length = 0;
+    cursor.pos = 0;
+    cursor.last = 0;
+    cursor.error = error;
+    return cursor;
+}
+
+JParser json_cursor_parser(JCursor *cursor, jsize_t pos)
+{
+    JParser parser = json_init_parser(0, cursor->input);
+    parser.length = cursor->length;
+    parser.pos = pos;
+    parser.arena = cursor->arena;
+    return parser;
+}
+
+JType json_cursor_type(JCursor *cursor)
+{
+    if (cursor->error != 1)
+        return JSON_ERROR;
+    switch (cursor->input[cursor->pos])
+    {
+    case '{': return JSON_OBJECT;
+    case '[': return JSON_ARRAY;
+    case '"': return JSON_STRING;
+    case 't':
+    case 'f': return JSON_BOOL;
+    case 'n': return JSON_NULL;
+    default:  return JSON_NUMBER;
+    }
+}
+
+// steps to the next element of an array or pair of an object, skipping
+// whatever was left unread of the previous one, returns 0 at the end
+int json_cursor_next(JCursor *container, char close, JCursor *value)
+{
+    if (container->error != 1)
+        return container->error;
+    if (container->last == JSON_NUL_TERMINATED)
+        return 0;
+    JParser parser = json_cursor_parser(container, container->pos + 1);
+    if (container->last != 0)
+    {
+        parser.pos = container->last;
+        int skipped = json_skip_value(&parser);
+        if (skipped != 1)
+            return skipped;
+    }
+    if (!json_skip_whitespaces(&parser))
+        return JSON_UNEXPECTED_EOF;
+    char c = json_peek(&parser);
+    if (c == close)
+    {
+        container->last = JSON_NUL_TERMINATED;
+        return 0;
+    }
+    if (container->last != 0)
+    {
+        if (c != ',')
+            return JSON_PARSE_ERROR;
+        parser.pos++;
+        if (!json_skip_whitespaces(&parser))
+            return JSON_UNEXPECTED_EOF;
+    }
+    *value = *container;
+    value->pos = parser.pos;
+    value->last = 0;
+    container->last = parser.pos;
+    return 1;
+}
+
+// `key` points at the unescaped text in the input
+int json_cursor_next_field(JCursor *object, JString *key, JCursor *value)
+{
+    if (object->error == 1 && object->input[object->pos] != '{')
+        return JSON_TYPE_ERROR;
+    JCursor key_cursor;
+    int next = json_cursor_next(object, '}', &key_cursor);
+    if (next != 1)
+        return next;
+    if (key_cursor.input[key_cursor.pos] != '"')
+        return JSON_PARSE_ERROR;
+    JParser parser = json_cursor_parser(object, key_cursor.pos);
+    int skipped = json_skip_string(&parser);
+    if (skipped != 1)
+        return skipped;
+    key->data = (char *)object->input + key_cursor.pos + 1;
+    key->length = parser.pos - key_cursor.pos - 2;
+    int match = json_match_char(&parser, ':');
+    if (match != 1)
+        return match;
+    if (!json_skip_whitespaces(&parser))
+        return JSON_UNEXPECTED_EOF;
+    *value = key_cursor;
+    value->pos = parser.pos;
+    object->last = parser.pos;
+    return 1;
+}
+
+int json_cursor_next_element(JCursor *array, JCursor *element)
+{
+    if (array->error == 1 && array->input[array->pos] != '[')
+        return JSON_TYPE_ERROR;
+    return json_cursor_next(array, ']', element);
+}
+
+// whether an unescaped key in the input matches `key`, escapes are decoded
+// one at a time so nothing is allocated
+int json_cursor_key_equals(JString raw, const char *key)
+{
+    jsize_t matched = 0;
+    jsize_t i = 0;
+    while (i < raw.length)
+    {
+        if (raw.data[i] != '\\')
+        {
+            if (key[matched] == '\0' || raw.data[i++] != key[matched++])
+                return 0;
+            continue;
+        }
+        // a high surrogate takes the escape of its low one along
+        jsize_t length = 2;
+        unsigned int code_point;
+        if (i + 1 < raw.length && raw.data[i + 1] == 'u')
+            length = i + 6 <= raw.length && json_hex4(raw.data + i + 2, &code_point) == 1 && code_point >= 0xD800 &&
+                             code_point <= 0xDBFF
+                         ? 12
+                         : 6;
+        char decoded[4];
+        jsize_t decoded_length;
+        if (i + length > raw.length || json_unescape(decoded, raw.data + i, length, &decoded_length) != 1)
+            return 0;
+        for (jsize_t j = 0; j < decoded_length; ++j)
+        {
+            if (key[matched] == '\0' || decoded[j] != key[matched++])
+                return 0;
+        }
+        i += length;
+    }
+    return key[matched] == '\0';
+}
+
+// searches from the last field found and wraps around to the first pair,
+// reading fields in input order takes a single pass over the object, the
+// values in between are skipped without being parsed
+JCursor json_cursor_find_field(JCursor *object, const char *key)
+{
+    if (object->error != 1)
+        return *object;
+    jsize_t start = object->last;
+    JString field;
+    JCursor value;
+    int next;
+    while ((next = json_cursor_next_field(object, &field, &value)) == 1)
+    {
+        if (json_cursor_key_equals(field, key))
+            return value;
+    }
+    if (next == 0 && start != 0)
+    {
+        object->last = 0;
+        while ((next = json_cursor_next_field(object, &field, &value)) == 1)
+        {
+            if (json_cursor_key_equals(field, key))
+                return value;
+            if (value.pos == start)
+            {
+                next = 0;
+                break;
+            }
+        }
+    }
+#if !defined(NDEBUG)
+    if (next == 0)
+        fprintf(stderr, "key \"%s\" was not found\n", key);
+#endif // NDEBUG
+    return json_cursor_error(next == 0 ? JSON_KEY_NOT_FOUND : (JCode)next);
+}
+
+JCursor json_cursor_at(JCursor *array, jsize_t idx)
+{
+    if (array->error != 1)
+        return *array;
+    JCursor elements = *array;
+    elements.last = 0;
+    JCursor element;
+    int next;
+    jsize_t i = 0;
+    while ((next = json_cursor_next_element(&elements, &element)) == 1)
+    {
+        if (i++ == idx)
+            return element;
+    }
+    return json_cursor_error(next == 0 ? JSON_KEY_NOT_FOUND : (JCode)next);
+}
+
+// parses the number at the cursor like json_parse_number does
+int json_cursor_number(JCursor *cursor, JValue *value)
+{
+    if (cursor->error != 1)
+        return cursor->error;
+    if (json_cursor_type(cursor) != JSON_NUMBER)
+        return JSON_TYPE_ERROR;
+    JParser parser = json_cursor_parser(cursor, cursor->pos);
+    *value = json_parse_number(&parser);
+    return value->type == JSON_ERROR ? value->error : 1;
+}
+
+int json_cursor_get_int(JCursor *cursor, long long *result)
+{
+    JValue value;
+    int parsed = json_cursor_number(cursor, &value);
+    return parsed == 1 ? json_as_int(&value, result) : parsed;
+}
+
+int json_cursor_get_uint(JCursor *cursor, unsigned long long *result)
+{
+    JValue value;
+    int parsed = json_cursor_number(cursor, &value);
+    return parsed == 1 ? json_as_uint(&value, result) : parsed;
+}
+
+int json_cursor_get_double(JCursor *cursor, double *result)
+{
+    JValue value;
+    int parsed = json_cursor_number(cursor, &value);
+    return parsed == 1 ? json_as_double(&value, result) : parsed;
+}
+
+int json_cursor_get_bool(JCursor *cursor, int *result)
+{
+    if (cursor->error != 1)
+        return cursor->error;
+    if (json_cursor_type(cursor) != JSON_BOOL)
+        return JSON_TYPE_ERROR;
+    JParser parser = json_cursor_parser(cursor, cursor->pos);
+    JValue value = json_parse_value(&parser);
+    if (value.type == JSON_ERROR)
+        return value.error;
+    *result = value.boolean;
+    return 1;
+}
+
+// strings without escapes point into the input and are not terminated,
+// escaped ones are decoded into the arena of the cursor
+int json_cursor_get_string(JCursor *cursor, JString *result)
+{
+    if (cursor->error != 1)
+        return cursor->error;
+    if (json_cursor_type(cursor) != JSON_STRING)
+        return JSON_TYPE_ERROR;
+    JParser parser = json_cursor_parser(cursor, cursor->pos);
+    parser.flags = JSON_ZERO_COPY;
+    JValue value = json_parse_string(&parser);
+    if (value.type == JSON_ERROR)
+        return value.error;
+    *result = value.string;
+    return 1;
+}
+
+// builds the whole value at the cursor, allocated from its arena
+JValue json_cursor_get_value(JCursor *cursor)
+{
+    if (cursor->error != 1)
+    {
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = (JCode)cursor->error;
+        return value;
+    }
+    JParser parser = json_cursor_parser(cursor, cursor->pos);
+    return json_parse_value(&parser);
+}
+
+// the arena has to outlive the stream and the tree, json_arena_free
+// releases both, nothing is read from a chunk after json_stream_feed returns
+JStreamParser json_stream_init(JArena *arena)
+{
+    JStreamParser stream;
+    stream.parser = json_init_parser(0, 0);
+    stream.parser.arena = arena;
+    stream.state = JSON_STREAM_VALUE;
+    stream.error = 1;
+    stream.escaped = 0;
+    stream.offset = 0;
+    stream.frames = 0;
+    stream.depth = 0;
+    stream.frames_capacity = 0;
+    stream.token = 0;
+    stream.token_length = 0;
+    stream.token_capacity = 0;
+    stream.root.type = JSON_NULL;
+    stream.root.null = 0;
+    return stream;
+}
+
+// makes room for `needed` bytes the way the scratch grows
+void *json_stream_grow(JStreamParser *stream, void *data, jsize_t used, jsize_t *capacity, jsize_t needed)
+{
+    if (needed <= *capacity)
+        return data;
+    jsize_t new_capacity = *capacity ? *capacity * 2 : JP_SCRATCH_INITIAL_SIZE;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+    void *grown = json_arena_alloc(stream->parser.arena, new_capacity, 8);
+    if (grown == 0)
+    {
+        stream->error = JSON_MEMORY_ERROR;
+        return 0;
+    }
+    json_memcpy(grown, data, used);
+    *capacity = new_capacity;
+    return grown;
+}
+
+int json_stream_append(JStreamParser *stream, const char *src, jsize_t size)
+{
+    char *token = (char *)json_stream_grow(stream, stream->token, stream->token_length,
+                                           &stream->token_capacity, stream->token_length + size);
+    if (token == 0)
+        return stream->error;
+    stream->token = token;
+    json_memcpy(stream->token + stream->token_length, src, size);
+    stream->token_length += size;
+    return 1;
+}
+
+// puts a finished value into the open container, or makes it the root
+int json_stream_add(JStreamParser *stream, JValue value)
+{
+    if (stream->depth == 0)
+    {
+        stream->root = value;
+        stream->state = JSON_STREAM_DONE;
+        return 1;
+    }
+    JParser *parser = &stream->parser;
+    if (stream->frames[stream->depth - 1].close == ']')
+    {
+        JValue *slot = (JValue *)json_scratch_push(parser, sizeof(JValue));
+        if (slot == 0)
+            return stream->error = JSON_MEMORY_ERROR;
+        *slot = value;
+    }
+    else
+        ((JPair *)(parser->scratch + parser->scratch_size) - 1)->value = value;
+    stream->state = JSON_STREAM_NEXT;
+    return 1;
+}
+
+int json_stream_open(JStreamParser *stream, char c)
+{
+    jsize_t capacity = stream->frames_capacity * sizeof(JStreamFrame);
+    JStreamFrame *frames = (JStreamFrame *)json_stream_grow(stream, stream->frames, stream->depth * sizeof(JStreamFrame),
+                                                            &capacity, (stream->depth + 1) * sizeof(JStreamFrame));
+    if (frames == 0)
+        return stream->error;
+    stream->frames = frames;
+    stream->frames_capacity = capacity / sizeof(JStreamFrame);
+    JStreamFrame *frame = stream->frames + stream->depth++;
+    frame->close = c == '{' ? '}' : ']';
+    frame->scratch_start = stream->parser.scratch_size;
+    stream->state = c == '{' ? JSON_STREAM_OBJECT_START : JSON_STREAM_ARRAY_START;
+    return 1;
+}
+
+// commits the innermost container to memory like json_parse_object and
+// json_parse_array do
+int json_stream_close(JStreamParser *stream)
+{
+    JParser *parser = &stream->parser;
+    JStreamFrame *frame = stream->frames + --stream->depth;
+    jsize_t size = frame->close == '}' ? sizeof(JPair) : sizeof(JValue);
+    jsize_t count = (parser->scratch_size - frame->scratch_start) / size;
+    if (!json_length_fits(count))
+        return stream->error = JSON_RANGE_ERROR;
+    void *data = 0;
+    if (count != 0)
+    {
+        data = json_alloc(parser, size * count);
+        if (data == 0)
+            return stream->error = JSON_MEMORY_ERROR;
+        json_memcpy(data, parser->scratch + frame->scratch_start, size * count);
+    }
+    parser->scratch_size = frame->scratch_start;
+    JValue value;
+    if (frame->close == '}')
+    {
+        value.type = JSON_OBJECT;
+        value.object.data = (JPair *)data;
+        value.object.length = count;
+    }
+    else
+    {
+        value.type = JSON_ARRAY;
+        value.array.data = (JValue *)data;
+        value.array.length = count;
+    }
+    return json_stream_add(stream, value);
+}
+
+// adds a parsed token to the tree, keys start a pair
+int json_stream_value(JStreamParser *stream, JValue value, int key)
+{
+    if (value.type == JSON_ERROR)
+    {
+        // the token is complete, so running out of it means a terminator in
+        // the middle
+        return stream->error = value.error == JSON_UNEXPECTED_EOF ? JSON_PARSE_ERROR : value.error;
+    }
+    if (!key)
+        return json_stream_add(stream, value);
+    JPair *pair = (JPair *)json_scratch_push(&stream->parser, sizeof(JPair));
+    if (pair == 0)
+        return stream->error = JSON_MEMORY_ERROR;
+    pair->key = value.string.data ? value.string.data : (char *)"";
+    pair->key_length = value.string.length;
+    pair->value.type = JSON_NULL;
+    pair->value.null = 0;
+    stream->state = JSON_STREAM_COLON;
+    return 1;
+}
+
+// parses the string or scalar gathered in `token`
+int json_stream_token(JStreamParser *stream, int key)
+{
+    JParser *parser = &stream->parser;
+    parser->input = stream->token;
+    parser->length = stream->token_length;
+    parser->pos = 0;
+    JValue value = key ? json_parse_string(parser) : json_parse_value(parser);
+    stream->token_length = 0;
+    if (value.type != JSON_ERROR && parser->pos != parser->length)
+    {
+#if !defined(NDEBUG)
+        fprintf(stderr, "unexpected '%c' after a value\n", parser->input[parser->pos]);
+#endif // NDEBUG
+        return stream->error = JSON_PARSE_ERROR;
+    }
+    return json_stream_value(stream, value, key);
+}
+
+// position of the closing quote of the string the stream is in, or `length`,
+// control characters are left to json_parse_string
+jsize_t json_stream_string_end(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length)
+{
+    for (;;)
+    {
+        if (stream->escaped)
+        {
+            if (pos >= length)
+                return length;
+            stream->escaped = 0;
+            pos++;
+        }
+        pos = json_scan_string(chunk, pos, length);
+        if (pos >= length || chunk[pos] == '"')
+            return pos;
+        stream->escaped = chunk[pos] == '\\';
+        pos++;
+    }
+}
+
+// bytes of numbers and literals
+int json_scalar_char(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '-' || c == '+' || c == '.';
+}
+
+// strings that end in their chunk are parsed straight from it, the others
+// are gathered in `token`
+jsize_t json_stream_string(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length, int key)
+{
+    stream->escaped = 0;
+    jsize_t end = json_stream_string_end(stream, chunk, pos + 1, length);
+    if (end == length)
+    {
+        stream->state = key ? JSON_STREAM_KEY_STRING : JSON_STREAM_STRING;
+        json_stream_append(stream, chunk + pos, length - pos);
+        return length;
+    }
+    JParser *parser = &stream->parser;
+    parser->input = chunk;
+    parser->length = end + 1;
+    parser->pos = pos;
+    json_stream_value(stream, json_parse_string(parser), key);
+    return end + 1;
+}
+
+// a scalar that reaches the end of its chunk may go on in the next one
+jsize_t json_stream_scalar(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length)
+{
+    jsize_t end = pos + 1;
+    while (end < length && json_scalar_char(chunk[end]))
+        end++;
+    if (end == length)
+    {
+        stream->state = JSON_STREAM_SCALAR;
+        json_stream_append(stream, chunk + pos, length - pos);
+        return length;
+    }
+    JParser *parser = &stream->parser;
+    parser->input = chunk;
+    parser->length = length;
+    parser->pos = pos;
+    json_stream_value(stream, json_parse_value(parser), 0);
+    return parser->pos;
+}
+
+// handles the byte at `pos` outside of strings and scalars, returns where
+// the next token starts
+jsize_t json_stream_step(JStreamParser *stream, const char *chunk, jsize_t pos, jsize_t length)
+{
+    char c = chunk[pos];
+    switch (stream->state)
+    {
+    case JSON_STREAM_OBJECT_START:
+        if (c == '}')
+        {
+            json_stream_close(stream);
+            return pos + 1;
+        }
+        // fallthrough
+    case JSON_STREAM_KEY:
+        if (c == '"')
+            return json_stream_string(stream, chunk, pos, length, 1);
+        break;
+    case JSON_STREAM_COLON:
+        if (c == ':')
+        {
+            stream->state = JSON_STREAM_VALUE;
+            return pos + 1;
+        }
+        break;
+    case JSON_STREAM_NEXT:
+        {
+            char close = stream->frames[stream->depth - 1].close;
+            if (c == ',')
+            {
+                stream->state = close == '}' ? JSON_STREAM_KEY : JSON_STREAM_VALUE;
+                return pos + 1;
+            }
+            if (c == close)
+            {
+                json_stream_close(stream);
+                return pos + 1;
+            }
+            break;
+        }
+    case JSON_STREAM_ARRAY_START:
+        if (c == ']')
+        {
+            json_stream_close(stream);
+            return pos + 1;
+        }
+        // fallthrough
+    case JSON_STREAM_VALUE:
+        if (c == '{' || c == '[')
+        {
+            json_stream_open(stream, c);
+            return pos + 1;
+        }
+        if (c == '"')
+            return json_stream_string(stream, chunk, pos, length, 0);
+        if (json_scalar_char(c))
+            return json_stream_scalar(stream, chunk, pos, length);
+        break;
+    default:
+        break;
+    }
+    stream->error = JSON_PARSE_ERROR;
+#if !defined(NDEBUG)
+    fprintf(stderr, "unexpected '%c' at %llu\n", c, stream->offset + pos);
+#endif // NDEBUG
+    return length;
+}
+
+// parses as much of the chunk as it can, the tokens split between chunks are
+// copied until they end, returns 1 or the JCode that stopped the stream
+int json_stream_feed(JStreamParser *stream, const char *chunk, jsize_t length)
+{
+    jsize_t pos = 0;
+    while (stream->error == 1 && pos < length)
+    {
+        switch (stream->state)
+        {
+        case JSON_STREAM_STRING:
+        case JSON_STREAM_KEY_STRING:
+            {
+                jsize_t end = json_stream_string_end(stream, chunk, pos, length);
+                if (end == length)
+                {
+                    json_stream_append(stream, chunk + pos, length - pos);
+                    pos = length;
+                    break;
+                }
+                if (json_stream_append(stream, chunk + pos, end + 1 - pos) == 1)
+                    json_stream_token(stream, stream->state == JSON_STREAM_KEY_STRING);
+                pos = end + 1;
+                break;
+            }
+        case JSON_STREAM_SCALAR:
+            {
+                jsize_t end = pos;
+                while (end < length && json_scalar_char(chunk[end]))
+                    end++;
+                if (json_stream_append(stream, chunk + pos, end - pos) == 1 && end < length)
+                    json_stream_token(stream, 0);
+                pos = end;
+                break;
+            }
+        default:
+            {
+                if (json_whitespace_char(chunk[pos]))
+                {
+                    // most runs are a single space after ':' or ','
+                    if (++pos < length && json_whitespace_char(chunk[pos]))
+                        pos = json_skip_whitespace_run(chunk, pos, length);
+                }
+                else
+                    pos = json_stream_step(stream, chunk, pos, length);
+                break;
+            }
+        }
+    }
+    stream->offset += length;
+    return stream->error;
+}
+
+// ends the input, returns the tree or the error that stopped the stream
+JValue json_stream_finish(JStreamParser *stream)
+{
+    if (stream->error == 1 && stream->state == JSON_STREAM_SCALAR)
+        json_stream_token(stream, 0);
+    if (stream->error != 1)
+    {
+        JValue value;
+        value.type = JSON_ERROR;
+        value.error = (JCode)stream->error;
+        return value;
+    }
+    if (stream->state != JSON_STREAM_DONE)
+        return json_unexpected_eof(stream->offset);
+    return stream->root;
+}
+
+#if defined(JP_SSE2)
+JP_NO_SANITIZE_ADDRESS unsigned long long json_comma_mask(const unsigned char *block)
+{
+    unsigned long long comma = 0;
+#if defined(JP_AVX2)
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 32)
+        comma |= json_avx2_eq(_mm256_load_si256((const __m256i *)(block + i)), ',') << i;
+#else
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 16)
+        comma |= json_sse2_eq(_mm_load_si128((const __m128i *)(block + i)), ',') << i;
+#endif // JP_AVX2
+    return comma;
+}
+#endif // JP_SSE2
+
+// pushes the positions of the '[' at `pos`, of every ',' between the
+// elements of its array and of its ']' to the scratch, the SIMD version skips
+// blocks that stay inside the elements like json_skip_container does, an
+// array closed by '}' is a JSON_PARSE_ERROR
+int json_index_elements(JParser *parser, jsize_t *count)
+{
+    jsize_t depth = 0;
+    parser->scratch_size = 0;
+#if defined(JP_SSE2)
+    const unsigned char *input = (const unsigned char *)parser->input;
+    const unsigned char *block = (const unsigned char *)((JP_UINTPTR)(input + parser->pos) & ~(JP_UINTPTR)(JSON_BLOCK_SIZE - 1));
+    unsigned long long prev_escaped = 0;
+    unsigned long long prev_in_string = 0;
+    for (;; block += JSON_BLOCK_SIZE)
+    {
+        JBrackets masks;
+        json_classify_brackets(block, &masks);
+        unsigned long long valid = ~0ULL;
+        if (block < input + parser->pos)
+            valid <<= input + parser->pos - block;
+        if (parser->length != JSON_NUL_TERMINATED)
+        {
+            jsize_t available = block < input ? parser->length + (jsize_t)(input - block) : parser->length - (jsize_t)(block - input);
+            if (available < JSON_BLOCK_SIZE)
+                masks.zero |= 1ULL << available;
+        }
+        unsigned long long end = masks.zero & valid;
+        if (end)
+            valid &= (end & (0ULL - end)) - 1;
+        unsigned long long escaped = json_escaped_mask(masks.backslash & valid, &prev_escaped);
+        unsigned long long in_string = json_prefix_xor(masks.quote & valid & ~escaped) ^ prev_in_string;
+        prev_in_string = 0ULL - (in_string >> 63);
+        unsigned long long open = masks.open & valid & ~in_string;
+        unsigned long long close = masks.close & valid & ~in_string;
+        // no comma of the root array and no end of it in this block
+        if (!end && depth >= 2 + (jsize_t)json_popcount(close))
+        {
+            depth += json_popcount(open) - json_popcount(close);
+            continue;
+        }
+        unsigned long long comma = json_comma_mask(block) & valid & ~in_string;
+        for (unsigned long long tokens = open | close | comma; tokens; tokens &= tokens - 1)
+        {
+            unsigned long long bit = tokens & (0ULL - tokens);
+            jsize_t pos = (jsize_t)(block + json_ctz(bit) - input);
+            if (open & bit)
+                depth++;
+            else if (close & bit)
+                depth--;
+            if (depth > 1 || (depth == 1 && (close & bit)))
+                continue;
+            jsize_t *separator = (jsize_t *)json_scratch_push(parser, sizeof(jsize_t));
+            if (separator == 0)
+                return JSON_MEMORY_ERROR;
+            *separator = pos;
+            if (depth == 0)
+            {
+                *count = parser->scratch_size / sizeof(jsize_t);
+                return parser->input[pos] == ']' ? 1 : JSON_PARSE_ERROR;
+            }
+        }
+        if (end)
+            return JSON_UNEXPECTED_EOF;
+    }
+#else
+    for (;;)
+    {
+        char c = json_peek(parser);
+        if (c == '\0')
+            return JSON_UNEXPECTED_EOF;
+        if (c == '"')
+        {
+            int skipped = json_skip_string(parser);
+            if (skipped != 1)
+                return skipped;
+            continue;
+        }
+        if (c == '{' || c == '[')
+            depth++;
+        else if (c == '}' || c == ']')
+            depth--;
+        if (((c == '[' || c == ',') && depth == 1) || ((c == ']' || c == '}') && depth == 0))
+        {
+            jsize_t *separator = (jsize_t *)json_scratch_push(parser, sizeof(jsize_t));
+            if (separator == 0)
+                return JSON_MEMORY_ERROR;
+            *separator = parser->pos;
+            if (depth == 0)
+            {
+                *count = parser->scratch_size / sizeof(jsize_t);
+                return c == ']' ? 1 : JSON_PARSE_ERROR;
+            }
+        }
+        parser->pos++;
+    }
+#endif // JP_SSE2
+}
+
+// parses every element of the range where it goes in the root array, an
+// element has to end right at its separator
+void json_array_work(void *arg)
+{
+    JArrayWorker *worker = (JArrayWorker *)arg;
+    JParser *parser = &worker->parser;
+    for (jsize_t i = worker->first; i < worker->last; ++i)
+    {
+        parser->pos = worker->separators[i] + 1;
+        parser->length = worker->separators[i + 1];
+        JValue value;
+        if (!json_skip_whitespaces(parser))
+        {
+            worker->error = JSON_PARSE_ERROR;
+            return;
+        }
+        value = json_parse_value(parser);
+        if (value.type == JSON_ERROR)
+        {
+            worker->error = value.error;
+            return;
+        }
+        if (json_skip_whitespaces(parser))
+        {
+            worker->error = JSON_PARSE_ERROR;
+            return;
+        }
+        worker->values[i] = value;
+    }
+}
+
+// json_parse_arena for a root array, its elements are split between
+// `threads` threads and parsed straight into the array, every thread into an
+// arena of its own over the same alloc and free, which has to be
+// thread-safe, that `arena` takes over afterwards, other roots and malformed
+// input are parsed on the calling thread, so the result and its errors are
+// the same, with JSON_INSITU the threads copy strings instead, which leaves
+// the input as it was for that
+JValue json_parse_parallel(JArena *arena, const char *input, jsize_t length, int flags, int threads)
+{
+    // the separators are only needed until the workers are done
+    JArena index = json_arena_init_custom(arena->alloc, arena->free);
+    JParser parser = json_init_parser(0, input);
+    parser.length = length;
+    parser.flags = flags;
+    parser.arena = &index;
+    jsize_t count;
+    if (threads > JP_MAX_THREADS)
+        threads = JP_MAX_THREADS;
+    if (threads < 2 || !json_skip_whitespaces(&parser) || json_peek(&parser) != '[' ||
+        json_index_elements(&parser, &count) != 1)
+    {
+        json_arena_free(&index);
+        return json_parse_arena(arena, input, length, flags);
+    }
+    const jsize_t *separators = (const jsize_t *)parser.scratch;
+    jsize_t elements = count - 1;
+    JValue value;
+    value.type = JSON_ARRAY;
+    value.array.data = 0;
+    value.array.length = 0;
+    parser.pos = separators[0] + 1;
+    parser.length = separators[1];
+    if (elements == 1 && !json_skip_whitespaces(&parser))
+    {
+        json_arena_free(&index);
+        return value;
+    }
+    JValue *values = (JValue *)json_arena_alloc(arena, sizeof(JValue) * elements, 8);
+    if (values == 0)
+    {
+        json_arena_free(&index);
+        value.type = JSON_ERROR;
+        value.error = JSON_MEMORY_ERROR;
+        return value;
+    }
+    if ((jsize_t)threads > elements)
+        threads = (int)elements;
+    JArrayWorker workers[JP_MAX_THREADS];
+    for (int i = 0; i < threads; ++i)
+    {
+        workers[i].arena = json_arena_init_custom(arena->alloc, arena->free);
+        workers[i].parser = json_init_parser(0, input);
+        workers[i].parser.flags = flags & ~JSON_INSITU;
+        workers[i].parser.arena = &workers[i].arena;
+        workers[i].separators = separators;
+        workers[i].values = values;
+        workers[i].first = elements * (jsize_t)i / (jsize_t)threads;
+        workers[i].last = elements * (jsize_t)(i + 1) / (jsize_t)threads;
+        workers[i].error = 1;
+    }
+    json_parallel(json_array_work, workers, sizeof(JArrayWorker), threads);
+    json_arena_free(&index);
+    int error = 1;
+    for (int i = 0; i < threads; ++i)
+    {
+        if (workers[i].error != 1)
+            error = workers[i].error;
+    }
+    for (int i = 0; i < threads; ++i)
+    {
+        if (error == 1)
+            json_arena_adopt(arena, &workers[i].arena);
+        else
+            json_arena_free(&workers[i].arena);
+    }
+    if (error != 1)
+        return json_parse_arena(arena, input, length, flags);
+    value.array.data = values;
+    value.array.length = elements;
+    return value;
+}
+
+int json_sax_parse(const char *input, jsize_t length, const JHandler *handler, void *user)
+{
+    JArena arena = json_arena_init();
+    int result = json_sax_parse_custom(&arena, input, length, 0, handler, user);
+    json_arena_free(&arena);
+    return result;
+}
+
+// drives the handler straight from the input, returns 1 or the JCode that
+// stopped it, only strings with escapes reach the arena, which is reset for
+// each of them
+int json_sax_parse_custom(JArena *arena, const char *input, jsize_t length, int flags, const JHandler *handler,
+                          void *user)
+{
+    // strings without escapes and bignums are passed as they are in the input
+    JParser parser = json_init_parser(0, input);
+    parser.length = length;
+    parser.flags = flags | JSON_ZERO_COPY;
+    parser.arena = arena;
+    json_skip_whitespaces(&parser);
+    return json_sax_value(&parser, handler, user);
+}
+
+int json_sax_value(JParser *parser, const JHandler *handler, void *user)
+{
+    JValue value;
+    switch (json_peek(parser))
+    {
+    case '{':
+        return json_sax_object(parser, handler, user);
+    case '[':
+        return json_sax_array(parser, handler, user);
+    case '"':
+        {
+            JString string;
+            int result = json_sax_string(parser, &string);
+            if (result == 1 && handler->on_string)
+                handler->on_string(user, string.data, string.length);
+            return result;
+        }
+    case 't':
+        value = json_parse_boolean(parser, 1, "true", 4);
+        break;
+    case 'f':
+        value = json_parse_boolean(parser, 0, "false", 5);
+        break;
+    case 'n':
+        value = json_parse_null(parser);
+        break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        value = json_parse_number(parser);
+        break;
+    default:
+#if !defined(NDEBUG)
+        fprintf(stderr, "unknown char %c at %llu\n", json_peek(parser), parser->pos);
+#endif // NDEBUG
+        return JSON_PARSE_ERROR;
+    }
+    if (value.type == JSON_ERROR)
+        return value.error;
+    if (value.type == JSON_BOOL)
+    {
+        if (handler->on_bool)
+            handler->on_bool(user, value.boolean);
+    }
+    else if (value.type == JSON_NULL)
+    {
+        if (handler->on_null)
+            handler->on_null(user);
+    }
+    else if (handler->on_number)
+        handler->on_number(user, value);
+    return 1;
+}
+
+int json_sax_object(JParser *parser, const JHandler *handler, void *user)
+{
+    parser->pos++;
+    if (handler->on_object_begin)
+        handler->on_object_begin(user);
+    if (!json_skip_whitespaces(parser))
+        return json_unexpected_eof(parser->pos).error;
+    if (parser->input[parser->pos] == '}')
+        parser->pos++;
+    else
+    {
+        for (;;)
+        {
+            if (!json_skip_whitespaces(parser))
+                return json_unexpected_eof(parser->pos).error;
+            if (parser->input[parser->pos] != '"')
+            {
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected '%c' found '%c' at %llu\n", '"', parser->input[parser->pos], parser->pos);
+#endif // NDEBUG
+                return JSON_PARSE_ERROR;
+            }
+            JString key;
+            int result = json_sax_string(parser, &key);
+            if (result != 1)
+                return result;
+            if (handler->on_key)
+                handler->on_key(user, key.data, key.length);
+            int match = json_match_char(parser, ':');
+            if (match == JSON_UNEXPECTED_EOF)
+                return json_unexpected_eof(parser->pos).error;
+            if (match == JSON_PARSE_ERROR)
+            {
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected '%c' found '%c' at %llu\n", ':', parser->input[parser->pos - 1],
+                        parser->pos - 1);
+#endif // NDEBUG
+                return JSON_PARSE_ERROR;
+            }
+            if (!json_skip_whitespaces(parser))
+                return json_unexpected_eof(parser->pos).error;
+            result = json_sax_value(parser, handler, user);
+            if (result != 1)
+                return result;
+            if (!json_skip_whitespaces(parser))
+                return json_unexpected_eof(parser->pos).error;
+            char c = parser->input[parser->pos++];
+            if (c == '}')
+                break;
+            if (c != ',')
+            {
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected ',' or '}' found '%c' at %llu\n", c, parser->pos - 1);
+#endif // NDEBUG
+                return JSON_PARSE_ERROR;
+            }
+        }
+    }
+    if (handler->on_object_end)
+        handler->on_object_end(user);
+    return 1;
+}
+
+int json_sax_array(JParser *parser, const JHandler *handler, void *user)
+{
+    parser->pos++;
+    if (handler->on_array_begin)
+        handler->on_array_begin(user);
+    if (!json_skip_whitespaces(parser))
+        return json_unexpected_eof(parser->pos).error;
+    if (parser->input[parser->pos] == ']')
+        parser->pos++;
+    else
+    {
+        for (;;)
+        {
+            if (!json_skip_whitespaces(parser))
+                return json_unexpected_eof(parser->pos).error;
+            int result = json_sax_value(parser, handler, user);
+            if (result != 1)
+                return result;
+            if (!json_skip_whitespaces(parser))
+                return json_unexpected_eof(parser->pos).error;
+            char c = parser->input[parser->pos++];
+            if (c == ']')
+                break;
+            if (c != ',')
+            {
+#if !defined(NDEBUG)
+                fprintf(stderr, "expected ',' or ']' found '%c' at %llu\n", c, parser->pos - 1);
+#endif // NDEBUG
+                return JSON_PARSE_ERROR;
+            }
+        }
+    }
+    if (handler->on_array_end)
+        handler->on_array_end(user);
+    return 1;
+}
+
+// escaped strings are decoded into the arena, which is reset for each one
+int json_sax_string(JParser *parser, JString *string)
+{
+    json_arena_reset(parser->arena);
+    JValue value = json_parse_string(parser);
+    int parsed = value.type == JSON_STRING;
+    string->data = parsed && value.string.data ? value.string.data : (char *)"";
+    string->length = parsed ? value.string.length : 0;
+    return parsed ? 1 : value.error;
+}
+
+// the tag of every word is its top byte, the rest is the payload:
+//   '{' '['            word of the matching close, the next value is past it
+//   '}' ']'            word of the matching open
+//   '"' 'b' 'r'        offset into the strings, the next word is the length
+//   'l' 'u' 'd'        nothing, the next word holds the bits
+//   't' 'f' 'n'        nothing
+#define JSON_TAPE_WORD(tag, payload) ((unsigned long long)(unsigned char)(tag) << 56 | (payload))
+#define JSON_TAPE_PAYLOAD_MASK ((1ULL << 56) - 1)
+
+int json_parse_tape(const char *input, jsize_t length, JTape *tape)
+{
+    JArena arena = json_arena_init();
+    return json_parse_tape_custom(arena.alloc, arena.free, input, length, 0, tape);
+}
+
+// the words and the strings take one allocation sized from the input, which
+// stays with the tape until json_tape_free, also after an error, escaped
+// strings take another one that is freed before returning
+int json_parse_tape_custom(void *(*alloc)(JP_ALLOC_SIZE_TYPE size), void (*free)(void *ptr), const char *input,
+                           jsize_t length, int flags, JTape *tape)
+{
+    tape->words = 0;
+    tape->length = 0;
+    tape->strings = 0;
+    tape->arena = json_arena_init_custom(alloc, free);
+    if (length == JSON_NUL_TERMINATED)
+    {
+        length = 0;
+        while (input[length] != '\0')
+            length++;
+    }
+    jsize_t words;
+    jsize_t strings;
+    json_measure_tape(input, length, &words, &strings);
+    char *block = (char *)json_arena_alloc(&tape->arena, words * sizeof(unsigned long long) + strings, 8);
+    if (block == 0)
+        return JSON_MEMORY_ERROR;
+    tape->words = (unsigned long long *)block;
+    tape->strings = block + words * sizeof(unsigned long long);
+    JTapeBuilder builder;
+    builder.tape = tape;
+    builder.open = 0;
+    builder.strings_size = 0;
+    JHandler handler;
+    handler.on_object_begin = json_tape_object_begin;
+    handler.on_object_end = json_tape_object_end;
+    handler.on_key = json_tape_string;
+    handler.on_string = json_tape_string;
+    handler.on_number = json_tape_number;
+    handler.on_bool = json_tape_bool;
+    handler.on_null = json_tape_null;
+    handler.on_array_begin = json_tape_array_begin;
+    handler.on_array_end = json_tape_array_end;
+    // escaped strings are decoded here before they are copied to the tape
+    JArena escaped = json_arena_init_custom(alloc, free);
+    int result = json_sax_parse_custom(&escaped, input, length, flags, &handler, &builder);
+    json_arena_free(&escaped);
+    if (result != 1)
+        tape->length = 0;
+    return result;
+}
+
+void json_tape_free(JTape *tape)
+{
+    json_arena_free(&tape->arena);
+    tape->words = 0;
+    tape->length = 0;
+    tape->strings = 0;
+}
+
+// the open word links to the enclosing container until it is closed
+void json_tape_open(void *user, char tag)
+{
+    JTapeBuilder *builder = (JTapeBuilder *)user;
+    JTape *tape = builder->tape;
+    tape->words[tape->length] = JSON_TAPE_WORD(tag, builder->open);
+    builder->open = tape->length++;
+}
+
+void json_tape_close(void *user, char tag)
+{
+    JTapeBuilder *builder = (JTapeBuilder *)user;
+    JTape *tape = builder->tape;
+    jsize_t open = builder->open;
+    builder->open = tape->words[open] & JSON_TAPE_PAYLOAD_MASK;
+    tape->words[open] = JSON_TAPE_WORD(tape->words[open] >> 56, tape->length);
+    tape->words[tape->length++] = JSON_TAPE_WORD(tag, open);
+}
+
+void json_tape_object_begin(void *user)
+{
+    json_tape_open(user, '{');
+}
+
+void json_tape_object_end(void *user)
+{
+    json_tape_close(user, '}');
+}
+
+void json_tape_array_begin(void *user)
+{
+    json_tape_open(user, '[');
+}
+
+void json_tape_array_end(void *user)
+{
+    json_tape_close(user, ']');
+}
+
+void json_tape_string(void *user, const char *string, jsize_t length)
+{
+    json_tape_text((JTapeBuilder *)user, '"', string, length);
+}
+
+void json_tape_text(JTapeBuilder *builder, char tag, const char *text, jsize_t length)
+{
+    JTape *tape = builder->tape;
+    tape->words[tape->length++] = JSON_TAPE_WORD(tag, builder->strings_size);
+    tape->words[tape->length++] = length;
+    json_memcpy(tape->strings + builder->strings_size, text, length);
+    tape->strings[builder->strings_size + length] = '\0';
+    builder->strings_size += length + 1;
+}
+
+void json_tape_number(void *user, JValue number)
+{
+    JTapeBuilder *builder = (JTapeBuilder *)user;
+    JTape *tape = builder->tape;
+    switch (number.type)
+    {
+    case JSON_NUMBER:
+        tape->words[tape->length++] = JSON_TAPE_WORD('l', 0);
+        tape->words[tape->length++] = (unsigned long long)number.number;
+        break;
+    case JSON_UNSIGNED:
+        tape->words[tape->length++] = JSON_TAPE_WORD('u', 0);
+        tape->words[tape->length++] = number.unsigned_number;
+        break;
+    case JSON_DOUBLE:
+        tape->words[tape->length++] = JSON_TAPE_WORD('d', 0);
+        json_memcpy(tape->words + tape->length++, &number.real, sizeof(number.real));
+        break;
+    default:
+        json_tape_text(builder, number.type == JSON_BIGNUM ? 'b' : 'r', number.string.data, number.string.length);
+        break;
+    }
+}
+
+void json_tape_bool(void *user, int value)
+{
+    JTape *tape = ((JTapeBuilder *)user)->tape;
+    tape->words[tape->length++] = JSON_TAPE_WORD(value ? 't' : 'f', 0);
+}
+
+void json_tape_null(void *user)
+{
+    JTape *tape = ((JTapeBuilder *)user)->tape;
+    tape->words[tape->length++] = JSON_TAPE_WORD('n', 0);
+}
+
+// an upper bound of the words and string bytes the tape of input[0, length)
+// takes, with the quotes and brackets outside of strings and the first byte
+// of every number and literal found a block at a time: a string takes 2 words and the bytes from its opening quote on, which leaves room
+// for the terminator, a number or literal takes 2 words and its bytes plus a
+// terminator, a bracket 1 word
+void json_measure_tape(const char *input, jsize_t length, jsize_t *words, jsize_t *strings)
+{
+    const unsigned char *start = (const unsigned char *)input;
+#if defined(JP_SSE2)
+    const unsigned char *block = (const unsigned char *)((JP_UINTPTR)start & ~(JP_UINTPTR)(JSON_BLOCK_SIZE - 1));
+#else
+    const unsigned char *block = start;
+#endif // JP_SSE2
+    JIndexState state;
+    state.prev_escaped = 0;
+    state.prev_in_string = 0;
+    state.prev_scalar = 0;
+    *words = 0;
+    *strings = 0;
+    for (;; block += JSON_BLOCK_SIZE)
+    {
+        JBlock masks;
+        jsize_t available = block < start ? length + (jsize_t)(start - block) : length - (jsize_t)(block - start);
+        json_classify_block(block, available, &masks);
+        unsigned long long valid = ~0ULL;
+        if (block < start)
+            valid <<= start - block;
+        if (available < JSON_BLOCK_SIZE)
+            masks.zero |= 1ULL << available;
+        unsigned long long end = masks.zero & valid;
+        if (end)
+            valid &= (end & (0ULL - end)) - 1;
+        unsigned long long escaped = json_escaped_mask(masks.backslash & valid, &state.prev_escaped);
+        unsigned long long quote = masks.quote & valid & ~escaped;
+        unsigned long long in_string = json_prefix_xor(quote) ^ state.prev_in_string;
+        state.prev_in_string = 0ULL - (in_string >> 63);
+        unsigned long long outside = valid & ~(in_string | quote);
+        unsigned long long scalar = outside & ~(masks.op | masks.whitespace);
+        unsigned long long scalar_starts = scalar & ~((scalar << 1) | state.prev_scalar);
+        state.prev_scalar = scalar >> 63;
+        *words += (jsize_t)(json_popcount(quote) + 2 * json_popcount(scalar_starts) +
+                            json_popcount(masks.bracket & outside));
+        *strings += (jsize_t)(json_popcount(in_string & valid) + json_popcount(scalar) + json_popcount(scalar_starts));
+        if (end)
+            return;
+    }
+}
+
+char json_tape_tag(const JTape *tape, jsize_t index)
+{
+    return (char)(tape->words[index] >> 56);
+}
+
+jsize_t json_tape_payload(const JTape *tape, jsize_t index)
+{
+    return tape->words[index] & JSON_TAPE_PAYLOAD_MASK;
+}
+
+// the word after the value, containers are stepped over in one go
+jsize_t json_tape_skip(const JTape *tape, jsize_t index)
+{
+    switch (json_tape_tag(tape, index))
+    {
+    case '{':
+    case '[':
+        return json_tape_payload(tape, index) + 1;
+    case 't':
+    case 'f':
+    case 'n':
+        return index + 1;
+    default:
+        return index + 2;
+    }
+}
+
+JTapeValue json_tape_root(const JTape *tape)
+{
+    if (tape->length == 0)
+        return json_tape_error(JSON_PARSE_ERROR);
+    JTapeValue value;
+    value.tape = tape;
+    value.index = 0;
+    value.last = 0;
+    value.error = 1;
+    return value;
+}
+
+JTapeValue json_tape_error(JCode error)
+{
+    JTapeValue value;
+    value.tape = 0;
+    value.index = 0;
+    value.last = 0;
+    value.error = error;
+    return value;
+}
+
+JType json_tape_type(JTapeValue *value)
+{
+    if (value->error != 1)
+        return JSON_ERROR;
+    switch (json_tape_tag(value->tape, value->index))
+    {
+    case '{': return JSON_OBJECT;
+    case '[': return JSON_ARRAY;
+    case '"': return JSON_STRING;
+    case 't':
+    case 'f': return JSON_BOOL;
+    case 'n': return JSON_NULL;
+    case 'l': return JSON_NUMBER;
+    case 'u': return JSON_UNSIGNED;
+    case 'd': return JSON_DOUBLE;
+    case 'b': return JSON_BIGNUM;
+    default:  return JSON_RAW_NUMBER;
+    }
+}
+
+// returns 1 with the next element, 0 at the end
+int json_tape_next_element(JTapeValue *array, JTapeValue *element)
+{
+    if (array->error != 1)
+        return array->error;
+    if (json_tape_type(array) != JSON_ARRAY)
+        return JSON_TYPE_ERROR;
+    jsize_t next = array->last == 0 ? array->index + 1 : json_tape_skip(array->tape, array->last);
+    if (json_tape_tag(array->tape, next) == ']')
+        return 0;
+    element->tape = array->tape;
+    element->index = next;
+    element->last = 0;
+    element->error = 1;
+    array->last = next;
+    return 1;
+}
+
+// returns 1 with the next pair, 0 at the end, the key is terminated
+int json_tape_next_field(JTapeValue *object, JString *key, JTapeValue *value)
+{
+    if (object->error != 1)
+        return object->error;
+    if (json_tape_type(object) != JSON_OBJECT)
+        return JSON_TYPE_ERROR;
+    const JTape *tape = object->tape;
+    jsize_t next = object->last == 0 ? object->index + 1 : json_tape_skip(tape, object->last);
+    if (json_tape_tag(tape, next) == '}')
+        return 0;
+    key->data = tape->strings + json_tape_payload(tape, next);
+    key->length = tape->words[next + 1];
+    value->tape = tape;
+    value->index = next + 2;
+    value->last = 0;
+    value->error = 1;
+    object->last = next + 2;
+    return 1;
+}
+
+JTapeValue json_tape_get(JTapeValue *object, const char *key)
+{
+    if (object->error != 1)
+        return *object;
+    if (json_tape_type(object) != JSON_OBJECT)
+        return json_tape_error(JSON_TYPE_ERROR);
+    const JTape *tape = object->tape;
+    jsize_t length = 0;
+    while (key[length] != '\0')
+        length++;
+    // each key is 2 words, its value is stepped over without being looked at,
+    // the strings are only read for keys of the same length
+    for (jsize_t index = object->index + 1; json_tape_tag(tape, index) != '}';
+         index = json_tape_skip(tape, index + 2))
+    {
+        if (tape->words[index + 1] == length &&
+            json_memcmp(key, tape->strings + json_tape_payload(tape, index), length) == 0)
+        {
+            JTapeValue value;
+            value.tape = tape;
+            value.index = index + 2;
+            value.last = 0;
+            value.error = 1;
+            return value;
+        }
+    }
+#if !defined(NDEBUG)
+    fprintf(stderr, "key \"%s\" was not found\n", key);
+#endif // NDEBUG
+    return json_tape_error(JSON_KEY_NOT_FOUND);
+}
+
+JTapeValue json_tape_at(JTapeValue *array, jsize_t idx)
+{
+    if (array->error != 1)
+        return *array;
+    JTapeValue elements = *array;
+    elements.last = 0;
+    JTapeValue element;
+    int next;
+    jsize_t i = 0;
+    while ((next = json_tape_next_element(&elements, &element)) == 1)
+    {
+        if (i++ == idx)
+            return element;
+    }
+    return json_tape_error(next == 0 ? JSON_KEY_NOT_FOUND : (JCode)next);
+}
+
+// scalars as a JValue, strings point into the tape, containers are a
+// JSON_TYPE_ERROR
+JValue json_tape_value(JTapeValue *tape_value)
+{
+    JValue value;
+    value.type = json_tape_type(tape_value);
+    if (value.type == JSON_ERROR)
+    {
+        value.error = (JCode)tape_value->error;
+        return value;
+    }
+    const JTape *tape = tape_value->tape;
+    jsize_t index = tape_value->index;
+    switch (value.type)
+    {
+    case JSON_OBJECT:
+    case JSON_ARRAY:
+        value.type = JSON_ERROR;
+        value.error = JSON_TYPE_ERROR;
+        break;
+    case JSON_BOOL:
+        value.boolean = json_tape_tag(tape, index) == 't';
+        break;
+    case JSON_NULL:
+        value.null = 0;
+        break;
+    case JSON_NUMBER:
+        value.number = (long long)tape->words[index + 1];
+        break;
+    case JSON_UNSIGNED:
+        value.unsigned_number = tape->words[index + 1];
+        break;
+    case JSON_DOUBLE:
+        json_memcpy(&value.real, tape->words + index + 1, sizeof(value.real));
+        break;
+    default:
+        value.string.data = tape->strings + json_tape_payload(tape, index);
+        value.string.length = tape->words[index + 1];
+        break;
     }
     return value;
 }
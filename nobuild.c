@@ -4,10 +4,12 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define CFLAGS "-Wall", "-Wextra", "-pedantic", "-std=c11", "-O0", "-ggdb"
+#define CFLAGS "-Wall", "-Wextra", "-pedantic", "-std=c11", "-O0", "-ggdb", "-pthread"
 #define MSVC_CFLAGS "/nologo", "/W3", "/std:c11"
-#define CXXFLAGS "-Wall", "-Wextra", "-pedantic", "-std=c++11", "-O0", "-ggdb"
+#define CXXFLAGS "-Wall", "-Wextra", "-pedantic", "-std=c++11", "-O0", "-ggdb", "-pthread"
 #define MSVC_CXXFLAGS "/nologo", "/W3", "/std:c++11"
+#define BENCH_CFLAGS "-Wall", "-Wextra", "-pedantic", "-std=c11", "-O2", "-pthread"
+#define MSVC_BENCH_CFLAGS "/nologo", "/W3", "/std:c11", "/O2"
 
 #ifdef _WIN32
 #define DEFAULT_CC "cl"
@@ -36,14 +38,21 @@ char cxx[32];
 void run_tests()
 {
     if (strcmp(cc, "cl") == 0)
+    {
         CMD(cc, MSVC_CFLAGS, "tests/test.c", "/Fe:", "c-tests");
+        CMD(cc, MSVC_CFLAGS, "/DJP_COMPACT", "tests/test.c", "/Fe:", "c-tests-compact");
+    }
     else
+    {
         CMD(cc, CFLAGS, "tests/test.c", "-o", "c-tests");
+        CMD(cc, CFLAGS, "-DJP_COMPACT", "tests/test.c", "-o", "c-tests-compact");
+    }
     if (strcmp(cxx, "cl") == 0)
         CMD(cxx, MSVC_CXXFLAGS, "tests/test.cpp", "/Fe:", "cxx-tests");
     else
         CMD(cxx, CXXFLAGS, "tests/test.cpp", "-o", "cxx-tests");
     RUN("c-tests");
+    RUN("c-tests-compact");
     RUN("cxx-tests");
 }
 
@@ -64,13 +73,22 @@ int main(int argc, char **argv)
             else
                 CMD(cc, CFLAGS, "examples/twitch-payload.c", "-o", "twitch-payload-c");
             RUN("twitch-payload-c");
-            if (cl)
-                CMD(cc, MSVC_CXXFLAGS, "examples/twitch-payload.cpp", "/Fe:", "twitch-payload-cpp");
+            if (strcmp(cxx, "cl") == 0)
+                CMD(cxx, MSVC_CXXFLAGS, "examples/twitch-payload.cpp", "/Fe:", "twitch-payload-cpp");
             else
-                CMD(cc, CXXFLAGS, "examples/twitch-payload.cpp", "-o", "twitch-payload-cpp");
+                CMD(cxx, CXXFLAGS, "examples/twitch-payload.cpp", "-o", "twitch-payload-cpp");
             RUN("twitch-payload-cpp");
             return 0;
         }
+        if (strcmp(argv[1], "bench") == 0)
+        {
+            if (strcmp(cc, "cl") == 0)
+                CMD(cc, MSVC_BENCH_CFLAGS, "bench/bench.c", "/Fe:", "bench-c");
+            else
+                CMD(cc, BENCH_CFLAGS, "bench/bench.c", "-o", "bench-c");
+            RUN("bench-c");
+            return 0;
+        }
     }
 
     run_tests();
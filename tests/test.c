@@ -6,6 +6,8 @@
 
 #include "test.h"
 
+#include <locale.h>
+
 void test_values(void)
 {
     char buffer[512] = {0};
@@ -245,7 +247,7 @@ void test_input(void)
                             JValue object_array_object_string = json_get(&object_array_object.object, "nested");
                             if (TEST(object_array_object_string.type == JSON_STRING))
                             {
-                                printf("nested string: %s, length: %llu\n", object_array_object_string.string.data, object_array_object_string.string.length);
+                                printf("nested string: %s, length: %llu\n", object_array_object_string.string.data, (jsize_t)object_array_object_string.string.length);
                             }
                         }
                     }
@@ -295,6 +297,1528 @@ void test_memory(void)
     }
 }
 
+void test_nested(void)
+{
+    const char *input = "{\"a\": [{\"b\": [1, {\"c\": 2}]}, {\"d\": []}], \"e\": {\"f\": {\"g\": [3, [4, 5]]}}}";
+
+    JValue json = json_parse(input);
+    if (!TEST(json.type == JSON_OBJECT))
+        return;
+    TEST(json.object.length == 2);
+
+    JValue a = json_get(&json.object, "a");
+    if (TEST(a.type == JSON_ARRAY) && TEST(a.array.length == 2))
+    {
+        JValue b = json_get(&a.array.data[0].object, "b");
+        if (TEST(b.type == JSON_ARRAY) && TEST(b.array.length == 2))
+        {
+            TEST(b.array.data[0].number == 1);
+            JValue c = json_get(&b.array.data[1].object, "c");
+            if (TEST(c.type == JSON_NUMBER))
+                TEST(c.number == 2);
+        }
+        JValue d = json_get(&a.array.data[1].object, "d");
+        if (TEST(d.type == JSON_ARRAY))
+            TEST(d.array.length == 0);
+    }
+
+    JValue e = json_get(&json.object, "e");
+    if (TEST(e.type == JSON_OBJECT))
+    {
+        JValue f = json_get(&e.object, "f");
+        if (TEST(f.type == JSON_OBJECT))
+        {
+            JValue g = json_get(&f.object, "g");
+            if (TEST(g.type == JSON_ARRAY) && TEST(g.array.length == 2))
+            {
+                TEST(g.array.data[0].number == 3);
+                if (TEST(g.array.data[1].type == JSON_ARRAY) && TEST(g.array.data[1].array.length == 2))
+                    TEST(g.array.data[1].array.data[1].number == 5);
+            }
+        }
+    }
+
+    JValue missing_comma = json_parse("[1 2]");
+    if (TEST(missing_comma.type == JSON_ERROR))
+        TEST(missing_comma.error == JSON_PARSE_ERROR);
+
+    JValue trailing_comma = json_parse("{\"a\": 1,}");
+    if (TEST(trailing_comma.type == JSON_ERROR))
+        TEST(trailing_comma.error == JSON_PARSE_ERROR);
+}
+
+void test_whitespaces(void)
+{
+    const char *input = "{\n"
+                        "    \"a\": [\n"
+                        "        1,\r\n"
+                        "\t\t2 ,                                   3\n"
+                        "    ],\n"
+                        "                                                                \"b\"  :  \"c\"\n"
+                        "}                    \n\n";
+    char buffer[256];
+    for (size_t offset = 0; offset < 32; ++offset)
+    {
+        char *aligned_input = buffer + offset;
+        strcpy(aligned_input, input);
+        JValue json = json_parse(aligned_input);
+        if (!TEST(json.type == JSON_OBJECT) || !TEST(json.object.length == 2))
+            return;
+        JValue a = json_get(&json.object, "a");
+        if (TEST(a.type == JSON_ARRAY) && TEST(a.array.length == 3))
+            TEST(a.array.data[2].number == 3);
+        JValue b = json_get(&json.object, "b");
+        if (TEST(b.type == JSON_STRING))
+            TEST(strcmp(b.string.data, "c") == 0);
+    }
+
+    JValue only_whitespaces = json_parse("                                        ");
+    TEST(only_whitespaces.type == JSON_ERROR);
+}
+
+void test_escapes(void)
+{
+    const char *input = "{\"quote\\\"key\": \"a \\\"quoted\\\" \\\\ string with a / and \\/ in it\", "
+                        "\"controls\": \"\\b\\f\\n\\r\\t\", "
+                        "\"unicode\": \"caf\\u00e9 \\u20AC \\ud83d\\ude00\", "
+                        "\"long\": \"0123456789abcdef0123456789abcdef\\\\0123456789abcdef\"}";
+    const int flags[] = {0, JSON_ZERO_COPY};
+    for (size_t i = 0; i < COUNT(flags); ++i)
+    {
+        JMemory memory = {.alloc = malloc};
+        JValue json = json_parse_flags(&memory, input, flags[i]);
+        if (!TEST(json.type == JSON_OBJECT))
+            return;
+
+        JValue quoted = json_get(&json.object, "quote\"key");
+        if (TEST(quoted.type == JSON_STRING))
+        {
+            TEST(strcmp(quoted.string.data, "a \"quoted\" \\ string with a / and / in it") == 0);
+            TEST(quoted.string.length == strlen("a \"quoted\" \\ string with a / and / in it"));
+        }
+
+        JValue controls = json_get(&json.object, "controls");
+        if (TEST(controls.type == JSON_STRING))
+            TEST(strcmp(controls.string.data, "\b\f\n\r\t") == 0);
+
+        JValue unicode = json_get(&json.object, "unicode");
+        if (TEST(unicode.type == JSON_STRING))
+        {
+            TEST(strcmp(unicode.string.data, "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80") == 0);
+            TEST(unicode.string.length == 14);
+        }
+
+        JValue long_string = json_get(&json.object, "long");
+        if (TEST(long_string.type == JSON_STRING))
+            TEST(strcmp(long_string.string.data, "0123456789abcdef0123456789abcdef\\0123456789abcdef") == 0);
+    }
+
+    const char *invalid[] = {
+        "\"\\x\"",
+        "\"\\u12\"",
+        "\"\\ud83d\"",
+        "\"\\ude00\"",
+        "\"raw\nnewline\"",
+        "\"unterminated \\\"",
+    };
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        JValue value = json_parse(invalid[i]);
+        TEST(value.type == JSON_ERROR);
+    }
+}
+
+void test_zero_copy(void)
+{
+    const char *input = "{\"name\": \"Ciremun\", \"\": \"empty key\", \"tags\": [\"a\", \"\", \"b\\nc\"]}";
+
+    JMemory memory = {.alloc = counting_alloc};
+    total_allocations = 0;
+    json_parse_custom(&memory, input);
+    size_t copy_allocations = total_allocations;
+    total_allocations = 0;
+    JValue json = json_parse_flags(&memory, input, JSON_ZERO_COPY);
+    if (!TEST(json.type == JSON_OBJECT))
+        return;
+    // only the escaped string is still allocated
+    TEST(copy_allocations - total_allocations == 5);
+
+    JValue name = json_get(&json.object, "name");
+    if (TEST(name.type == JSON_STRING))
+    {
+        TEST(name.string.data == input + 10);
+        TEST(name.string.length == 7);
+        TEST(memcmp(name.string.data, "Ciremun", 7) == 0);
+    }
+    TEST(json.object.data[0].key == input + 2);
+    TEST(json.object.data[0].key_length == 4);
+
+    JValue empty_key = json_get(&json.object, "");
+    if (TEST(empty_key.type == JSON_STRING))
+        TEST(empty_key.string.length == 9);
+    TEST(json_get(&json.object, "nam").type == JSON_ERROR);
+    TEST(json_get(&json.object, "names").type == JSON_ERROR);
+
+    JValue tags = json_get(&json.object, "tags");
+    if (TEST(tags.type == JSON_ARRAY) && TEST(tags.array.length == 3))
+    {
+        TEST(tags.array.data[0].string.data == strstr(input, "\"a\"") + 1);
+        TEST(tags.array.data[1].string.length == 0);
+        JValue escaped = tags.array.data[2];
+        TEST(escaped.string.length == 3);
+        TEST(strcmp(escaped.string.data, "b\nc") == 0);
+    }
+
+    JValue view = json_parse_view("[\"view\"]");
+    if (TEST(view.type == JSON_ARRAY))
+        TEST(memcmp(view.array.data[0].string.data, "view\"", 5) == 0);
+}
+
+void test_insitu(void)
+{
+    char input[] = "{\"key\": \"value\", \"escaped\\tkey\": [\"a\\\"b\", \"\\u00e9\", \"\"]}trailing";
+    jsize_t length = strlen(input) - strlen("trailing");
+    char *end = input + sizeof(input);
+
+    JValue json = json_parse_insitu(input, length);
+    if (!TEST(json.type == JSON_OBJECT))
+        return;
+    TEST(strcmp(json.object.data[0].key, "key") == 0);
+    TEST(json.object.data[0].key >= input && json.object.data[0].key < end);
+
+    JValue value = json_get(&json.object, "key");
+    if (TEST(value.type == JSON_STRING))
+    {
+        TEST(strcmp(value.string.data, "value") == 0);
+        TEST(value.string.data >= input && value.string.data < end);
+    }
+
+    JValue array = json_get(&json.object, "escaped\tkey");
+    if (TEST(array.type == JSON_ARRAY) && TEST(array.array.length == 3))
+    {
+        TEST(strcmp(array.array.data[0].string.data, "a\"b") == 0);
+        TEST(array.array.data[0].string.length == 3);
+        TEST(strcmp(array.array.data[1].string.data, "\xC3\xA9") == 0);
+        TEST(array.array.data[2].string.length == 0);
+        TEST(array.array.data[2].string.data >= input && array.array.data[2].string.data < end);
+    }
+
+    // an empty string is terminated where its closing quote was
+    char empty[] = "{\"a\":\"\"}";
+    JValue empty_string = json_parse_insitu(empty, strlen(empty));
+    if (TEST(empty_string.type == JSON_OBJECT))
+    {
+        JValue a = json_get(&empty_string.object, "a");
+        TEST(a.type == JSON_STRING && a.string.length == 0 && a.string.data == empty + 6);
+        TEST(a.string.data != 0 && strcmp(a.string.data, "") == 0);
+    }
+
+    char truncated[] = "[\"abc\", 1]";
+    JValue eof = json_parse_insitu(truncated, 4);
+    if (TEST(eof.type == JSON_ERROR))
+        TEST(eof.error == JSON_UNEXPECTED_EOF);
+
+    char literal[] = "[true]";
+    JValue cut_literal = json_parse_insitu(literal, 4);
+    TEST(cut_literal.type == JSON_ERROR);
+}
+
+void test_length(void)
+{
+    const char *inputs[] = {
+        "{\"k\": [1, -2, true, false, null, \"string\", \"esc\\\"aped\", {}, []]}",
+        "   \"indented string\"   ",
+        "12345",
+        "[\"0123456789abcdef0123456789abcdef\"]",
+    };
+    const int flags[] = {0, JSON_ZERO_COPY};
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        jsize_t length = strlen(inputs[i]);
+        for (size_t j = 0; j < COUNT(flags); ++j)
+        {
+            // no terminator, every byte past the input belongs to someone else
+            char *input = (char *)malloc(length);
+            memcpy(input, inputs[i], length);
+            JMemory memory = {.alloc = malloc};
+            JValue value = json_parse_custom_n(&memory, input, length, flags[j]);
+            TEST(value.type != JSON_ERROR);
+            // containers are open until the last byte
+            for (jsize_t cut = 0; cut < length && strchr("{[", input[0]); ++cut)
+            {
+                JValue truncated = json_parse_custom_n(&memory, input, cut, flags[j]);
+                TEST(truncated.type == JSON_ERROR);
+            }
+            free(input);
+        }
+    }
+
+    const char *number = "1337, garbage";
+    JValue value = json_parse_n(number, 4);
+    if (TEST(value.type == JSON_NUMBER))
+        TEST(value.number == 1337);
+    value = json_parse_n(number, 2);
+    if (TEST(value.type == JSON_NUMBER))
+        TEST(value.number == 13);
+
+    JValue embedded_terminator = json_parse_n("[1,\0 2]", 7);
+    TEST(embedded_terminator.type == JSON_ERROR);
+}
+
+void test_doubles(void)
+{
+    const char *inputs[] = {
+        "3.14",
+        "-0.5",
+        "1e10",
+        "2.5E-3",
+        "1E+2",
+        "0.1",
+        "1e23",
+        "9007199254740993.0",
+        "1.7976931348623157e308",
+        "4.9406564584124654e-324",
+        "2.2250738585072011e-308",
+        "1e400",
+        "1e-400",
+        "123456789012345678901234567890.5e-10",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124999",
+    };
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        JValue value = json_parse(inputs[i]);
+        // correctly rounded, the same bits as strtod
+        double expected = strtod(inputs[i], 0);
+        if (TEST(value.type == JSON_DOUBLE))
+            TEST(memcmp(&value.real, &expected, sizeof(expected)) == 0);
+    }
+    // the strtod fallback reads '.' whatever the locale, skipped when no
+    // locale with a decimal comma is installed
+    const char *halfway = "1.00000000000000011102230246251565404236316680908203126";
+    double above = strtod(halfway, 0);
+    if (setlocale(LC_NUMERIC, "de_DE.UTF-8") || setlocale(LC_NUMERIC, "fr_FR.UTF-8"))
+    {
+        JValue value = json_parse(halfway);
+        TEST(value.type == JSON_DOUBLE && value.real == above && above > 1.0);
+        setlocale(LC_NUMERIC, "C");
+    }
+
+    JValue coordinates = json_parse("{\"type\": \"Point\", \"coordinates\": [-122.4194155, 37.7749295]}");
+    if (TEST(coordinates.type == JSON_OBJECT))
+    {
+        JValue point = json_get(&coordinates.object, "coordinates");
+        if (TEST(point.type == JSON_ARRAY && point.array.length == 2))
+        {
+            TEST(point.array.data[0].type == JSON_DOUBLE && point.array.data[0].real == -122.4194155);
+            TEST(point.array.data[1].type == JSON_DOUBLE && point.array.data[1].real == 37.7749295);
+        }
+    }
+
+    const char *invalid[] = {"1.", ".5", "-", "1e", "1e+", "1.e5", "1.5.2", "1e5e5", "--1", "1.5x", "[1.5f]"};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        JValue value = json_parse(invalid[i]);
+        if (TEST(value.type == JSON_ERROR))
+            TEST(value.error == JSON_PARSE_ERROR);
+    }
+}
+
+void test_integers(void)
+{
+    struct
+    {
+        const char *input;
+        long long number;
+    } numbers[] = {
+        {"0", 0},
+        {"-0", 0},
+        {"7", 7},
+        {"12345678", 12345678},
+        {"123456789", 123456789},
+        {"-1234567890123456", -1234567890123456LL},
+        {"12345678901234567", 12345678901234567LL},
+        {"9223372036854775807", 9223372036854775807LL},
+        {"-9223372036854775808", -9223372036854775807LL - 1},
+    };
+    for (size_t i = 0; i < COUNT(numbers); ++i)
+    {
+        JValue value = json_parse(numbers[i].input);
+        if (TEST(value.type == JSON_NUMBER))
+            TEST(value.number == numbers[i].number);
+        // the 8 digit blocks must stop at the length, not at the terminator
+        jsize_t length = strlen(numbers[i].input);
+        value = json_parse_n(numbers[i].input, length - 1);
+        if (length > 1 && numbers[i].input[length - 2] != '-' && TEST(value.type == JSON_NUMBER))
+            TEST(value.number == numbers[i].number / 10);
+    }
+
+    JValue value = json_parse("9223372036854775808");
+    if (TEST(value.type == JSON_UNSIGNED))
+        TEST(value.unsigned_number == 9223372036854775808ULL);
+    value = json_parse("18446744073709551615");
+    if (TEST(value.type == JSON_UNSIGNED))
+        TEST(value.unsigned_number == 18446744073709551615ULL);
+
+    const char *bignums[] = {"18446744073709551616", "-9223372036854775809", "123456789012345678901234567890"};
+    for (size_t i = 0; i < COUNT(bignums); ++i)
+    {
+        value = json_parse(bignums[i]);
+        if (TEST(value.type == JSON_BIGNUM))
+            TEST(value.string.length == strlen(bignums[i]) && strcmp(value.string.data, bignums[i]) == 0);
+    }
+
+    JValue ids = json_parse("[10000000000000001, 10000000000000002, 18446744073709551616]");
+    if (TEST(ids.type == JSON_ARRAY && ids.array.length == 3))
+    {
+        TEST(ids.array.data[0].type == JSON_NUMBER && ids.array.data[0].number == 10000000000000001LL);
+        TEST(ids.array.data[1].type == JSON_NUMBER && ids.array.data[1].number == 10000000000000002LL);
+        TEST(ids.array.data[2].type == JSON_BIGNUM);
+    }
+
+    const char *invalid[] = {"01", "-01", "00", "0123456789", "123456789a"};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        value = json_parse(invalid[i]);
+        if (TEST(value.type == JSON_ERROR))
+            TEST(value.error == JSON_PARSE_ERROR);
+    }
+}
+
+void test_lazy_numbers(void)
+{
+    const char *input = "{\"id\": 18446744073709551615, \"count\": -42, \"ratio\": 0.25, "
+                        "\"big\": 123456789012345678901234567890, \"name\": \"lazy\"}";
+    JMemory memory = {.alloc = malloc};
+    JValue json = json_parse_flags(&memory, input, JSON_LAZY_NUMBERS);
+    if (!TEST(json.type == JSON_OBJECT))
+        return;
+    JValue *id = &json.object.data[0].value;
+    JValue *count = &json.object.data[1].value;
+    JValue *ratio = &json.object.data[2].value;
+    JValue *big = &json.object.data[3].value;
+    JValue *name = &json.object.data[4].value;
+    TEST(id->type == JSON_RAW_NUMBER && id->string.data == input + 7 && id->string.length == 20);
+    TEST(count->type == JSON_RAW_NUMBER && ratio->type == JSON_RAW_NUMBER && big->type == JSON_RAW_NUMBER);
+
+    long long signed_result;
+    unsigned long long unsigned_result;
+    double double_result;
+    TEST(json_as_int(id, &signed_result) == JSON_RANGE_ERROR);
+    // converted once, the value keeps the result
+    TEST(id->type == JSON_UNSIGNED);
+    TEST(json_as_uint(id, &unsigned_result) == 1 && unsigned_result == 18446744073709551615ULL);
+    TEST(json_as_int(count, &signed_result) == 1 && signed_result == -42);
+    TEST(count->type == JSON_NUMBER);
+    TEST(json_as_uint(count, &unsigned_result) == JSON_RANGE_ERROR);
+    TEST(json_as_double(count, &double_result) == 1 && double_result == -42.0);
+    TEST(json_as_double(ratio, &double_result) == 1 && double_result == 0.25);
+    TEST(ratio->type == JSON_DOUBLE);
+    TEST(json_as_int(ratio, &signed_result) == JSON_TYPE_ERROR);
+    // the text of bignums survives the conversion
+    TEST(json_as_double(big, &double_result) == 1 && double_result == 123456789012345678901234567890.0);
+    if (TEST(big->type == JSON_BIGNUM))
+        TEST(big->string.length == 30 && json_memcmp(big->string.data, "123456789012345678901234567890", 30) == 0);
+    TEST(json_as_double(name, &double_result) == JSON_TYPE_ERROR);
+
+    // json_get hands out copies, the field accessors convert in the tree
+    json = json_parse_flags(&memory, input, JSON_LAZY_NUMBERS);
+    JValue copy = json_get(&json.object, "ratio");
+    TEST(json_as_double(&copy, &double_result) == 1 && copy.type == JSON_DOUBLE);
+    TEST(json_get(&json.object, "ratio").type == JSON_RAW_NUMBER);
+    TEST(json_get_ptr(&json.object, "ratio") == &json.object.data[2].value);
+    TEST(json_get_double(&json.object, "ratio", &double_result) == 1 && double_result == 0.25);
+    TEST(json_get(&json.object, "ratio").type == JSON_DOUBLE);
+    TEST(json_get_double(&json.object, "ratio", &double_result) == 1 && double_result == 0.25);
+    TEST(json_get_int(&json.object, "count", &signed_result) == 1 && signed_result == -42);
+    TEST(json_get(&json.object, "count").type == JSON_NUMBER);
+    TEST(json_get_uint(&json.object, "id", &unsigned_result) == 1 && json_get(&json.object, "id").type == JSON_UNSIGNED);
+    TEST(json_get_int(&json.object, "missing", &signed_result) == JSON_KEY_NOT_FOUND);
+    TEST(json_get_ptr(&json.object, "missing") == 0);
+
+    // the grammar is still checked while parsing
+    const char *invalid[] = {"[01]", "[1.]", "[-]", "[1e+]", "[1.5x]"};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        JValue value = json_parse_flags(&memory, invalid[i], JSON_LAZY_NUMBERS);
+        if (TEST(value.type == JSON_ERROR))
+            TEST(value.error == JSON_PARSE_ERROR);
+    }
+
+    // eager values go through the same accessors
+    JValue eager = json_parse("[7, 2.5]");
+    if (TEST(eager.type == JSON_ARRAY))
+    {
+        TEST(json_as_int(&eager.array.data[0], &signed_result) == 1 && signed_result == 7);
+        TEST(json_as_double(&eager.array.data[1], &double_result) == 1 && double_result == 2.5);
+    }
+}
+
+// json_skip_value for containers one byte at a time
+int reference_skip(const char *input, size_t length, size_t *end)
+{
+    size_t depth = 0;
+    for (size_t i = 0; i < length && input[i]; ++i)
+    {
+        char c = input[i];
+        if (c == '"')
+        {
+            for (++i;; ++i)
+            {
+                if (i >= length || input[i] == '\0')
+                    return JSON_UNEXPECTED_EOF;
+                if (input[i] == '"')
+                    break;
+                if (input[i] == '\\' && (++i >= length || input[i] == '\0'))
+                    return JSON_UNEXPECTED_EOF;
+            }
+            continue;
+        }
+        if (c == '{' || c == '[')
+            depth++;
+        else if ((c == '}' || c == ']') && --depth == 0)
+        {
+            *end = i + 1;
+            return 1;
+        }
+    }
+    return JSON_UNEXPECTED_EOF;
+}
+
+void test_skip(void)
+{
+    const char alphabet[] = "{}[][[]]\"\"\\ ab1\n";
+    char buffer[512];
+    unsigned int seed = 1337;
+    for (int round = 0; round < 20000; ++round)
+    {
+        seed = seed * 1103515245 + 12345;
+        size_t offset = (seed >> 16) % 64;
+        seed = seed * 1103515245 + 12345;
+        size_t length = (seed >> 16) % 300 + 1;
+        char *input = buffer + offset;
+        input[0] = '[';
+        // backslashes only show up inside strings, like in valid JSON
+        int in_string = 0, escaped = 0;
+        for (size_t i = 1; i < length + 64; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            char c = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+            if (!in_string)
+            {
+                if (c == '\\')
+                    c = 'b';
+                in_string = c == '"';
+            }
+            else if (escaped)
+                escaped = 0;
+            else if (c == '\\')
+                escaped = 1;
+            else if (c == '"')
+                in_string = 0;
+            input[i] = c;
+        }
+        // every other round ends at a terminator instead of the length
+        int terminated = round & 1;
+        if (terminated)
+            input[length] = '\0';
+        size_t expected_end = 0;
+        int expected = reference_skip(input, length, &expected_end);
+
+        JMemory memory = {.alloc = malloc};
+        JParser parser = json_init_parser(&memory, input);
+        if (!terminated)
+            parser.length = length;
+        int skipped = json_skip_value(&parser);
+        if (!TEST(skipped == expected) || (expected == 1 && !TEST(parser.pos == expected_end)))
+        {
+            printf("input: '%.*s'\n", (int)length, input);
+            return;
+        }
+    }
+
+    const char *input = "{\"a\": [1, {\"b\": \"}]\\\"\"}, [[]]], \"c\": true} tail";
+    JMemory memory = {.alloc = malloc};
+    JParser parser = json_init_parser(&memory, input);
+    TEST(json_skip_value(&parser) == 1 && strcmp(input + parser.pos, " tail") == 0);
+    // skipping allocates nothing
+    size_t allocations = total_allocations;
+    memory.alloc = counting_alloc;
+    parser = json_init_parser(&memory, input);
+    TEST(json_skip_value(&parser) == 1 && total_allocations == allocations);
+}
+
+void test_cursor(void)
+{
+    const char *input = "{\"name\": \"Ciremun\", \"skipped\": {\"deep\": [1, \"]}\\\"\", {}]}, "
+                        "\"id\": 6969, \"ratio\": 0.5, \"partnered\": false, \"esc\\u0061ped\": \"a\\nb\", "
+                        "\"tags\": [\"one\", \"two\", \"three\"], \"empty\": []}";
+    JArena arena = json_arena_init_custom(counting_alloc, free);
+    size_t allocations = total_allocations;
+    JCursor root = json_cursor_begin(&arena, input, strlen(input));
+    TEST(json_cursor_type(&root) == JSON_OBJECT);
+
+    // fields can be looked up in any order
+    long long id;
+    JCursor id_cursor = json_cursor_find_field(&root, "id");
+    TEST(json_cursor_get_int(&id_cursor, &id) == 1 && id == 6969);
+    JString name;
+    JCursor name_cursor = json_cursor_find_field(&root, "name");
+    if (TEST(json_cursor_get_string(&name_cursor, &name) == 1))
+        TEST(name.length == 7 && json_memcmp(name.data, "Ciremun", 7) == 0);
+    double ratio;
+    JCursor ratio_cursor = json_cursor_find_field(&root, "ratio");
+    TEST(json_cursor_get_double(&ratio_cursor, &ratio) == 1 && ratio == 0.5);
+    int partnered = 1;
+    JCursor partnered_cursor = json_cursor_find_field(&root, "partnered");
+    TEST(json_cursor_get_bool(&partnered_cursor, &partnered) == 1 && partnered == 0);
+    TEST(json_cursor_get_int(&partnered_cursor, &id) == JSON_TYPE_ERROR);
+    JString escaped;
+    JCursor escaped_cursor = json_cursor_find_field(&root, "escaped");
+    if (TEST(json_cursor_get_string(&escaped_cursor, &escaped) == 1))
+        TEST(escaped.length == 3 && json_memcmp(escaped.data, "a\nb", 3) == 0);
+
+    JCursor missing = json_cursor_find_field(&root, "missing");
+    TEST(missing.error == JSON_KEY_NOT_FOUND);
+    // the search wraps around from the last field found
+    JCursor wrapped = json_cursor_find_field(&root, "escaped");
+    TEST(json_cursor_type(&wrapped) == JSON_STRING);
+    wrapped = json_cursor_find_field(&root, "name");
+    TEST(json_cursor_type(&wrapped) == JSON_STRING);
+    // errors carry through further lookups
+    JCursor nested_missing = json_cursor_find_field(&missing, "deeper");
+    TEST(nested_missing.error == JSON_KEY_NOT_FOUND && json_cursor_type(&nested_missing) == JSON_ERROR);
+
+    JCursor tags = json_cursor_find_field(&root, "tags");
+    const char *expected[] = {"one", "two", "three"};
+    JCursor tag;
+    size_t count = 0;
+    int next;
+    while ((next = json_cursor_next_element(&tags, &tag)) == 1)
+    {
+        JString string;
+        if (TEST(count < COUNT(expected) && json_cursor_get_string(&tag, &string) == 1))
+            TEST(string.length == strlen(expected[count]) && json_memcmp(string.data, expected[count], string.length) == 0);
+        count++;
+    }
+    TEST(next == 0 && count == 3);
+    TEST(json_cursor_next_element(&tags, &tag) == 0);
+    JCursor empty = json_cursor_find_field(&root, "empty");
+    TEST(json_cursor_next_element(&empty, &tag) == 0);
+    JCursor second = json_cursor_at(&tags, 1);
+    JString string;
+    TEST(json_cursor_get_string(&second, &string) == 1 && json_memcmp(string.data, "two", 3) == 0);
+    TEST(json_cursor_at(&tags, 3).error == JSON_KEY_NOT_FOUND);
+    TEST(json_cursor_next_element(&root, &tag) == JSON_TYPE_ERROR);
+
+    // pairs come in input order, keys are left escaped
+    JCursor pairs = json_cursor_begin(&arena, input, strlen(input));
+    JString key;
+    JCursor value;
+    count = 0;
+    while (json_cursor_next_field(&pairs, &key, &value) == 1)
+        count++;
+    TEST(count == 8);
+
+    JCursor skipped = json_cursor_find_field(&root, "skipped");
+    JValue subtree = json_cursor_get_value(&skipped);
+    if (TEST(subtree.type == JSON_OBJECT))
+    {
+        JValue deep = json_get(&subtree.object, "deep");
+        TEST(deep.type == JSON_ARRAY && deep.array.length == 3);
+    }
+    // what was read is released with the arena
+    TEST(total_allocations > allocations && json_arena_size(&arena) != 0);
+    json_arena_free(&arena);
+    TEST(json_arena_capacity(&arena) == 0);
+
+    const char *truncated = "{\"a\": [1, 2, {\"b\": \"unterminated}";
+    JCursor broken = json_cursor_begin(&arena, truncated, strlen(truncated));
+    TEST(json_cursor_find_field(&broken, "c").error == JSON_UNEXPECTED_EOF);
+
+    // escaped keys are compared without being decoded first
+    const char *keys = "{\"\\u00e9t\\u00e9\": 1, \"\\ud83d\\ude00\": 2, \"a\\\"b\": 3, \"ab\\u0000\": 4}";
+    arena = json_arena_init_custom(counting_alloc, free);
+    allocations = total_allocations;
+    JCursor object = json_cursor_begin(&arena, keys, strlen(keys));
+    JCursor found = json_cursor_find_field(&object, "\xc3\xa9t\xc3\xa9");
+    TEST(json_cursor_get_int(&found, &id) == 1 && id == 1);
+    found = json_cursor_find_field(&object, "\xf0\x9f\x98\x80");
+    TEST(json_cursor_get_int(&found, &id) == 1 && id == 2);
+    found = json_cursor_find_field(&object, "a\"b");
+    TEST(json_cursor_get_int(&found, &id) == 1 && id == 3);
+    TEST(json_cursor_find_field(&object, "\xc3\xa9t").error == JSON_KEY_NOT_FOUND);
+    TEST(json_cursor_find_field(&object, "\xc3\xa9t\xc3\xa9t").error == JSON_KEY_NOT_FOUND);
+    TEST(json_cursor_find_field(&object, "ab").error == JSON_KEY_NOT_FOUND);
+    TEST(total_allocations == allocations);
+    // strings read with the cursor come from its arena
+    const char *strings = "[\"a\\tb\"]";
+    JCursor array = json_cursor_begin(&arena, strings, strlen(strings));
+    JCursor first = json_cursor_at(&array, 0);
+    TEST(json_cursor_get_string(&first, &string) == 1 && string.length == 3 && json_memcmp(string.data, "a\tb", 3) == 0);
+    TEST(total_allocations == allocations + 1 && json_arena_size(&arena) != 0);
+    json_arena_free(&arena);
+}
+
+int values_equal(JValue a, JValue b)
+{
+    if (a.type != b.type)
+        return 0;
+    switch (a.type)
+    {
+    case JSON_OBJECT:
+        if (a.object.length != b.object.length)
+            return 0;
+        for (jsize_t i = 0; i < a.object.length; ++i)
+        {
+            JPair *pa = a.object.data + i;
+            JPair *pb = b.object.data + i;
+            if (pa->key_length != pb->key_length || (pa->key_length && memcmp(pa->key, pb->key, pa->key_length) != 0) ||
+                !values_equal(pa->value, pb->value))
+                return 0;
+        }
+        return 1;
+    case JSON_ARRAY:
+        if (a.array.length != b.array.length)
+            return 0;
+        for (jsize_t i = 0; i < a.array.length; ++i)
+            if (!values_equal(a.array.data[i], b.array.data[i]))
+                return 0;
+        return 1;
+    case JSON_STRING:
+    case JSON_BIGNUM:
+        return a.string.length == b.string.length &&
+               (a.string.length == 0 || memcmp(a.string.data, b.string.data, a.string.length) == 0);
+    case JSON_BOOL:
+        return a.boolean == b.boolean;
+    case JSON_NUMBER:
+    case JSON_UNSIGNED:
+        return a.unsigned_number == b.unsigned_number;
+    case JSON_DOUBLE:
+        return memcmp(&a.real, &b.real, sizeof(double)) == 0;
+    case JSON_ERROR:
+        return a.error == b.error;
+    default:
+        return 1;
+    }
+}
+
+JValue stream_parse(const char *input, size_t length, size_t chunk_size)
+{
+    JArena arena = json_arena_init();
+    JStreamParser stream = json_stream_init(&arena);
+    for (size_t pos = 0; pos < length; pos += chunk_size)
+    {
+        // every chunk is a copy that is gone after the feed
+        size_t size = length - pos < chunk_size ? length - pos : chunk_size;
+        char *chunk = (char *)malloc(size);
+        memcpy(chunk, input + pos, size);
+        json_stream_feed(&stream, chunk, size);
+        memset(chunk, 'x', size);
+        free(chunk);
+    }
+    return json_stream_finish(&stream);
+}
+
+void test_stream(void)
+{
+    const char *inputs[] = {
+        "{\"k\": [1, -2, true, false, null, \"string\", \"esc\\\"aped\", {}, []], \"\": {\"nested\": [[[]]]}}",
+        "  [\"\\\\\", \"\\u00e9\\ud83d\\ude00\", \"0123456789abcdef0123456789abcdef\\n\", \"\"]  ",
+        "[3.14, -0.5, 1e10, 2.5E-3, 1E+2, 123456789012345678901234567890, 18446744073709551615, -9223372036854775808]",
+        "12345",
+        "\"root string\"",
+        "null",
+        "\n{\n    \"_id\": 1,\n    \"notifications\": {\"email\": false, \"push\": true}\n}\n",
+    };
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        size_t length = strlen(inputs[i]);
+        JValue expected = json_parse(inputs[i]);
+        TEST(expected.type != JSON_ERROR);
+        for (size_t chunk_size = 1; chunk_size <= length; ++chunk_size)
+        {
+            JValue value = stream_parse(inputs[i], length, chunk_size);
+            if (!TEST(values_equal(value, expected)))
+            {
+                printf("input: '%s', chunks of %zu\n", inputs[i], chunk_size);
+                break;
+            }
+        }
+    }
+
+    const char *truncated[] = {"", "[", "{\"a\"", "{\"a\":", "[1,", "\"abc", "\"abc\\", "{\"a\": 1"};
+    for (size_t i = 0; i < COUNT(truncated); ++i)
+    {
+        JValue value = stream_parse(truncated[i], strlen(truncated[i]), 1);
+        if (TEST(value.type == JSON_ERROR))
+            TEST(value.error == JSON_UNEXPECTED_EOF);
+    }
+
+    const char *invalid[] = {"[1,]", "{\"a\" 1}", "[1 2]", "{1: 2}", "[truex]", "[1.]", "\"raw\nnewline\"",
+                             "\"\\x\"", "[1]]", "{} x", "[-]", "[tru", "{\"a\": 1,}"};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        for (size_t chunk_size = 1; chunk_size <= 3; ++chunk_size)
+        {
+            JValue value = stream_parse(invalid[i], strlen(invalid[i]), chunk_size);
+            if (TEST(value.type == JSON_ERROR))
+                TEST(value.error == JSON_PARSE_ERROR);
+        }
+    }
+
+    // a number at the end of a chunk only ends with the input
+    JArena arena = json_arena_init();
+    JStreamParser stream = json_stream_init(&arena);
+    TEST(json_stream_feed(&stream, "12", 2) == 1);
+    TEST(json_stream_feed(&stream, "34", 2) == 1);
+    JValue number = json_stream_finish(&stream);
+    if (TEST(number.type == JSON_NUMBER))
+        TEST(number.number == 1234);
+
+    // errors stick
+    stream = json_stream_init(&arena);
+    TEST(json_stream_feed(&stream, "[}", 2) == JSON_PARSE_ERROR);
+    TEST(json_stream_feed(&stream, "]", 1) == JSON_PARSE_ERROR);
+    TEST(json_stream_finish(&stream).type == JSON_ERROR);
+    json_arena_free(&arena);
+}
+
+typedef struct
+{
+    size_t count;
+    jsize_t lines[8];
+    JValue values[8];
+    long long sum;
+    // the last string record, values only live until the callback returns
+    char string[8];
+} Records;
+
+void collect_record(void *user, jsize_t line, JValue value)
+{
+    Records *records = (Records *)user;
+    if (records->count < COUNT(records->lines))
+    {
+        records->lines[records->count] = line;
+        records->values[records->count] = value;
+    }
+    records->count++;
+    if (value.type == JSON_STRING && value.string.length < sizeof(records->string))
+        memcpy(records->string, value.string.data, value.string.length + 1);
+    if (value.type == JSON_OBJECT)
+    {
+        JValue id = json_get(&value.object, "id");
+        if (id.type == JSON_NUMBER)
+            records->sum += id.number;
+    }
+}
+
+void check_escaped_record(void *user, jsize_t line, JValue value)
+{
+    int *checked = (int *)user;
+    (void)line;
+    if (TEST(value.type == JSON_ARRAY) && TEST(value.array.length == 20000))
+    {
+        JValue last = value.array.data[19999];
+        TEST(last.type == JSON_STRING && strcmp(last.string.data, "a\n19999") == 0);
+    }
+    ++*checked;
+}
+
+void test_lines(void)
+{
+    const char *input = "{\"id\": 1, \"tags\": [\"a\", \"b\"]}\n"
+                        "\n"
+                        "{\"id\": 2}\r\n"
+                        "{\"id\": 3,}\n"
+                        "   \t\n"
+                        "[1, 2] [3]\n"
+                        "\"last\"";
+    Records records = {0};
+    jsize_t errors = json_parse_lines(input, strlen(input), collect_record, &records);
+    TEST(errors == 2);
+    if (TEST(records.count == 5))
+    {
+        TEST(records.lines[0] == 1 && records.values[0].type == JSON_OBJECT);
+        TEST(records.lines[1] == 3 && records.values[1].type == JSON_OBJECT);
+        TEST(records.lines[2] == 4 && records.values[2].type == JSON_ERROR);
+        TEST(records.lines[3] == 6 && records.values[3].type == JSON_ERROR);
+        TEST(records.lines[4] == 7 && records.values[4].type == JSON_STRING);
+        TEST(records.values[4].type == JSON_STRING && strcmp(records.string, "last") == 0);
+    }
+    TEST(records.sum == 3);
+
+    // records bigger than the arena make it grow, the rest reuse it
+    char *lines = (char *)malloc(1024 * 1024);
+    size_t length = 0;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        length += sprintf(lines + length, "{\"id\": %d, \"payload\": [", i);
+        for (int j = 0; j < (i == 500 ? 5000 : 3); ++j)
+            length += sprintf(lines + length, "%s\"0123456789abcdef0123456789abcdef\"", j ? ", " : "");
+        length += sprintf(lines + length, "]}\n");
+    }
+    JArena arena = json_arena_init_custom(counting_alloc, free);
+    size_t allocations = total_allocations;
+    records = (Records){0};
+    errors = json_parse_lines_custom(&arena, lines, length, 0, collect_record, &records);
+    TEST(errors == 0);
+    TEST(records.count == 1000);
+    TEST(records.sum == 500500);
+    TEST(total_allocations - allocations < 16);
+
+    // with JSON_INSITU a record that outgrows the arena is decoded once
+    length = sprintf(lines, "[");
+    for (int i = 0; i < 20000; ++i)
+        length += sprintf(lines + length, "%s\"a\\n%05d\"", i ? ", " : "", i);
+    length += sprintf(lines + length, "]\n");
+    int checked = 0;
+    errors = json_parse_lines_custom(&arena, lines, length, JSON_INSITU, check_escaped_record, &checked);
+    TEST(errors == 0 && checked == 1);
+    json_arena_free(&arena);
+    free(lines);
+
+    // no terminator needed, the last line ends with the length
+    records = (Records){0};
+    json_parse_lines("1\n2\n3", 3, collect_record, &records);
+    if (TEST(records.count == 2))
+        TEST(records.values[1].type == JSON_NUMBER && records.values[1].number == 2);
+}
+
+void test_many(void)
+{
+    JArena arena = json_arena_init();
+    const char *input = "{\"a\": 1}[2]\"s\"  3\n true{}null";
+    JMany many = json_parse_many(&arena, input, strlen(input), 0);
+    JValue document;
+    jsize_t end = 0;
+    JType types[] = {JSON_OBJECT, JSON_ARRAY, JSON_STRING, JSON_NUMBER, JSON_BOOL, JSON_OBJECT, JSON_NULL};
+    jsize_t ends[] = {8, 11, 14, 17, 23, 25, 29};
+    for (int i = 0; i < 7; ++i)
+    {
+        TEST(json_many_next(&many, &document, &end) == 1);
+        TEST(document.type == types[i]);
+        TEST(end == ends[i]);
+    }
+    TEST(json_many_next(&many, &document, &end) == 0);
+    TEST(json_many_next(&many, &document, &end) == 0);
+
+    // a malformed document ends the walk
+    many = json_parse_many(&arena, "[1] {\"a\" 1} [2]", JSON_NUL_TERMINATED, 0);
+    TEST(json_many_next(&many, &document, &end) == 1 && end == 3);
+    TEST(json_many_next(&many, &document, &end) == JSON_PARSE_ERROR);
+    TEST(document.type == JSON_ERROR);
+    TEST(json_many_next(&many, &document, &end) == JSON_PARSE_ERROR);
+    many = json_parse_many(&arena, "[1] [2", JSON_NUL_TERMINATED, 0);
+    TEST(json_many_next(&many, &document, &end) == 1);
+    TEST(json_many_next(&many, &document, &end) == JSON_UNEXPECTED_EOF);
+
+    // the arena only grows for the largest document
+    char *documents = (char *)malloc(1024 * 1024);
+    size_t length = 0;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        length += sprintf(documents + length, "{\"id\": %d, \"payload\": [", i);
+        for (int j = 0; j < (i == 500 ? 5000 : 3); ++j)
+            length += sprintf(documents + length, "%s\"0123456789abcdef0123456789abcdef\"", j ? ", " : "");
+        length += sprintf(documents + length, "]}");
+    }
+    JArena counting = json_arena_init_custom(counting_alloc, free);
+    size_t allocations = total_allocations;
+    int count = 0;
+    double sum = 0;
+    many = json_parse_many(&counting, documents, length, 0);
+    while (json_many_next(&many, &document, &end) == 1)
+    {
+        count++;
+        sum += json_get(&document.object, "id").number;
+    }
+    TEST(count == 1000);
+    TEST(sum == 500500);
+    TEST(end == length);
+    TEST(total_allocations - allocations < 16);
+
+    // with JSON_INSITU a document that outgrows the arena is decoded once
+    length = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        length += sprintf(documents + length, "[");
+        for (int j = 0; j < 20000; ++j)
+            length += sprintf(documents + length, "%s\"a\\n%05d\"", j ? ", " : "", j);
+        length += sprintf(documents + length, "]");
+    }
+    many = json_parse_many(&counting, documents, length, JSON_INSITU);
+    for (int i = 0; i < 2; ++i)
+    {
+        if (TEST(json_many_next(&many, &document, &end) == 1) && TEST(document.array.length == 20000))
+        {
+            JValue last = document.array.data[19999];
+            TEST(last.type == JSON_STRING && strcmp(last.string.data, "a\n19999") == 0);
+        }
+    }
+    TEST(json_many_next(&many, &document, &end) == 0);
+    json_arena_free(&counting);
+    json_arena_free(&arena);
+    free(documents);
+}
+
+void test_parallel(void)
+{
+    char *input = (char *)malloc(64 * 1024);
+    char *copy = (char *)malloc(64 * 1024);
+    size_t length = sprintf(input, "[");
+    for (int i = 0; i < 1000; ++i)
+        length += sprintf(input + length, "%s{\"id\": %d, \"name\": \"\\u0041%d\"}", i ? ", " : "", i, i);
+    length += sprintf(input + length, "]");
+    memcpy(copy, input, length + 1);
+    JArena arena = json_arena_init();
+    JValue array = json_parse_parallel(&arena, input, length, JSON_INSITU, 4);
+    if (TEST(array.type == JSON_ARRAY) && TEST(array.array.length == 1000))
+    {
+        JValue last = array.array.data[999];
+        TEST(json_get(&last.object, "id").number == 999);
+        TEST(strcmp(json_get(&last.object, "name").string.data, "A999") == 0);
+    }
+    // the input is left as it was for the calling thread to report the error
+    memcpy(input, copy, length + 1);
+    strcpy(input + length - 1, ", tru]");
+    strcpy(copy + length - 1, ", tru]");
+    JValue expected = json_parse_arena(&arena, copy, length + 5, JSON_INSITU);
+    array = json_parse_parallel(&arena, input, length + 5, JSON_INSITU, 4);
+    TEST(expected.type == JSON_ERROR && expected.error == JSON_PARSE_ERROR);
+    TEST(array.type == JSON_ERROR && array.error == expected.error);
+
+    // malformed roots come out the way the serial parser reports them, also
+    // when the elements span several blocks
+    const char *malformed[] = {"[1,2}", "[{\"a\":1},2}", "[1,[2}]", "[1,2", "[{\"a\": [1,", "[\"]\", 2",
+                               "[1,2] x", "[1,2]]", "[] {}", "[1,,2]", "[,]", "[1 2]"};
+    for (size_t i = 0; i < COUNT(malformed); ++i)
+    {
+        for (int padded = 0; padded < 2; ++padded)
+        {
+            length = sprintf(input, "%s", padded ? "[\"0123456789abcdef0123456789abcdef0123456789abcdef0123456789\", " : "");
+            length += sprintf(input + length, "%s", malformed[i] + padded);
+            expected = json_parse_arena(&arena, input, length, 0);
+            array = json_parse_parallel(&arena, input, length, 0, 4);
+            if (!TEST(array.type == expected.type) ||
+                !TEST(expected.type == JSON_ERROR ? array.error == expected.error : values_equal(array, expected)))
+                printf("input: '%s'\n", input);
+        }
+    }
+    json_arena_free(&arena);
+    free(input);
+    free(copy);
+}
+
+void test_file(void)
+{
+    JFile file;
+    JArena arena = json_arena_init_custom(counting_alloc, free);
+    size_t allocations = total_allocations;
+    JValue json = json_parse_file(&arena, "tests/test_input.json", &file);
+    if (TEST(json.type == JSON_OBJECT) && TEST(json.object.length == 9))
+    {
+        // zero copy strings point into the mapping
+        JValue string = json_get(&json.object, "string");
+        if (TEST(string.type == JSON_STRING))
+        {
+            TEST(string.string.data > file.data && string.string.data < file.data + file.size);
+            TEST(string.string.length == 11 && memcmp(string.string.data, "test string", 11) == 0);
+        }
+        TEST(json_get(&json.object, "number").number == 12345);
+    }
+    // the tree is the arena's, it takes a single chunk
+    TEST(total_allocations == allocations + 1);
+    json_unmap_file(&file);
+    TEST(file.size == 0);
+
+    // the copy-on-write mapping takes the terminators, the file doesn't
+    char *original = read_file_as_str("tests/test_input.json");
+    JMemory memory = {.alloc = malloc};
+    json = json_parse_file_custom(&memory, "tests/test_input.json", JSON_INSITU, &file);
+    if (TEST(json.type == JSON_OBJECT))
+        TEST(strcmp(json_get(&json.object, "string").string.data, "test string") == 0);
+    json_unmap_file(&file);
+    char *after = read_file_as_str("tests/test_input.json");
+    TEST(strcmp(original, after) == 0);
+    free(original);
+    free(after);
+
+    json = json_parse_file(&arena, "tests/missing.json", &file);
+    TEST(json.type == JSON_ERROR && json.error == JSON_FILE_ERROR);
+
+    FILE *empty = fopen("test_file_empty.json", "wb");
+    if (TEST(empty != 0))
+    {
+        fclose(empty);
+        json = json_parse_file(&arena, "test_file_empty.json", &file);
+        TEST(json.type == JSON_ERROR && json.error == JSON_PARSE_ERROR);
+        json_unmap_file(&file);
+        remove("test_file_empty.json");
+    }
+    json_arena_free(&arena);
+}
+
+// the events of json_sax_parse written out as space separated tokens
+typedef struct
+{
+    char text[1024];
+    size_t length;
+} Events;
+
+void event_append(void *user, const char *prefix, const char *data, size_t length)
+{
+    Events *events = (Events *)user;
+    size_t prefix_length = strlen(prefix);
+    if (events->length + prefix_length + length + 2 > sizeof(events->text))
+        return;
+    memcpy(events->text + events->length, prefix, prefix_length);
+    memcpy(events->text + events->length + prefix_length, data, length);
+    events->length += prefix_length + length;
+    events->text[events->length++] = ' ';
+    events->text[events->length] = '\0';
+}
+
+void event_object_begin(void *user)
+{
+    event_append(user, "{", "", 0);
+}
+
+void event_object_end(void *user)
+{
+    event_append(user, "}", "", 0);
+}
+
+void event_array_begin(void *user)
+{
+    event_append(user, "[", "", 0);
+}
+
+void event_array_end(void *user)
+{
+    event_append(user, "]", "", 0);
+}
+
+void event_key(void *user, const char *key, jsize_t length)
+{
+    event_append(user, "k:", key, length);
+}
+
+void event_string(void *user, const char *string, jsize_t length)
+{
+    event_append(user, "s:", string, length);
+}
+
+void event_bool(void *user, int value)
+{
+    event_append(user, value ? "true" : "false", "", 0);
+}
+
+void event_null(void *user)
+{
+    event_append(user, "null", "", 0);
+}
+
+
+void event_number(void *user, JValue number)
+{
+    char text[64];
+    if (number.type == JSON_NUMBER)
+        sprintf(text, "%lld", number.number);
+    else if (number.type == JSON_DOUBLE)
+        sprintf(text, "%g", number.real);
+    else if (number.type == JSON_UNSIGNED)
+        sprintf(text, "%llu", number.unsigned_number);
+    else
+        sprintf(text, "%.*s", (int)number.string.length, number.string.data);
+    event_append(user, "n:", text, strlen(text));
+}
+
+void test_sax(void)
+{
+    JHandler handler = {
+        .on_object_begin = event_object_begin,
+        .on_object_end = event_object_end,
+        .on_key = event_key,
+        .on_string = event_string,
+        .on_number = event_number,
+        .on_bool = event_bool,
+        .on_null = event_null,
+        .on_array_begin = event_array_begin,
+        .on_array_end = event_array_end,
+    };
+    struct
+    {
+        const char *input;
+        const char *events;
+    } cases[] = {
+        {"{}", "{ } "},
+        {" [ ] ", "[ ] "},
+        {"\"\"", "s: "},
+        {"{\"a\": [1, -2.5, true, false, null], \"b\": {\"c\": \"d\"}}",
+         "{ k:a [ n:1 n:-2.5 true false null ] k:b { k:c s:d } } "},
+        {"[\"esc\\n\\u0041\", {\"k\\\"ey\": 18446744073709551615}]", "[ s:esc\nA { k:k\"ey n:18446744073709551615 } ] "},
+        {"[123456789012345678901234567890]", "[ n:123456789012345678901234567890 ] "},
+    };
+    for (size_t i = 0; i < COUNT(cases); ++i)
+    {
+        Events events = {0};
+        if (!TEST(json_sax_parse(cases[i].input, strlen(cases[i].input), &handler, &events) == 1) ||
+            !TEST(strcmp(events.text, cases[i].events) == 0))
+            printf("input: '%s'\nevents: '%s'\n", cases[i].input, events.text);
+    }
+
+    // numbers stay text with JSON_LAZY_NUMBERS
+    JArena arena = json_arena_init_custom(counting_alloc, free);
+    Events events = {0};
+    TEST(json_sax_parse_custom(&arena, "[1.50, 2]", 9, JSON_LAZY_NUMBERS, &handler, &events) == 1);
+    TEST(strcmp(events.text, "[ n:1.50 n:2 ] ") == 0);
+
+    // the events before an error have been delivered
+    events = (Events){0};
+    TEST(json_sax_parse("{\"a\": [1, 2}", JSON_NUL_TERMINATED, &handler, &events) == JSON_PARSE_ERROR);
+    TEST(strcmp(events.text, "{ k:a [ n:1 n:2 ") == 0);
+    JHandler silent = {0};
+    const char *invalid[] = {"{\"a\" 1}", "{1: 2}", "[1 2]", "[tru]", "[\"\\x\"]", "x", "{\"a\": 1,}", ""};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+        TEST(json_sax_parse(invalid[i], JSON_NUL_TERMINATED, &silent, 0) == JSON_PARSE_ERROR);
+    const char *truncated[] = {"[", "{\"a\"", "{\"a\":", "[1,", "\"abc"};
+    for (size_t i = 0; i < COUNT(truncated); ++i)
+        TEST(json_sax_parse(truncated[i], JSON_NUL_TERMINATED, &silent, 0) == JSON_UNEXPECTED_EOF);
+
+    // nothing is allocated unless a string has escapes
+    size_t allocations = total_allocations;
+    char *input = read_file_as_str("tests/test_input.json");
+    TEST(json_sax_parse_custom(&arena, input, strlen(input), 0, &silent, 0) == 1);
+    free(input);
+    TEST(total_allocations == allocations);
+    input = (char *)malloc(1024);
+    size_t length = sprintf(input, "[\"");
+    for (int i = 0; i < 100; ++i)
+        length += sprintf(input + length, "\\t%d", i % 10);
+    length += sprintf(input + length, "\", \"\\t\"]");
+    events = (Events){0};
+    TEST(json_sax_parse_custom(&arena, input, length, 0, &(JHandler){.on_string = event_string}, &events) == 1);
+    TEST(total_allocations > allocations);
+    TEST(events.length == 2 + 200 + 1 + 2 + 1 + 1);
+    TEST(events.text[2] == '\t' && events.text[3] == '0' && events.text[201] == '9');
+    free(input);
+    // the arena is reset for every escaped string, the first chunk is reused
+    allocations = total_allocations;
+    TEST(json_sax_parse_custom(&arena, "[\"\\t\", \"\\n\"]", JSON_NUL_TERMINATED, 0, &silent, 0) == 1);
+    TEST(total_allocations == allocations);
+    json_arena_free(&arena);
+}
+
+// walks the tape value and the tree together
+int tape_equals(JTapeValue tape_value, JValue value)
+{
+    if (json_tape_type(&tape_value) != value.type)
+        return 0;
+    JString key;
+    JTapeValue child;
+    jsize_t i = 0;
+    if (value.type == JSON_OBJECT)
+    {
+        while (json_tape_next_field(&tape_value, &key, &child) == 1)
+        {
+            JPair *pair = value.object.data + i++;
+            if (i > value.object.length || key.length != pair->key_length ||
+                (key.length && memcmp(key.data, pair->key, key.length) != 0) || !tape_equals(child, pair->value))
+                return 0;
+        }
+        return i == value.object.length;
+    }
+    if (value.type == JSON_ARRAY)
+    {
+        while (json_tape_next_element(&tape_value, &child) == 1)
+        {
+            if (i >= value.array.length || !tape_equals(child, value.array.data[i++]))
+                return 0;
+        }
+        return i == value.array.length;
+    }
+    return values_equal(json_tape_value(&tape_value), value);
+}
+
+void test_tape(void)
+{
+    const char *inputs[] = {
+        "{}",
+        "[]",
+        "\"\"",
+        "-12",
+        "[1, -2.5, 18446744073709551615, 123456789012345678901234567890, true, false, null]",
+        "{\"a\": {\"b\": [[], {}, [{\"c\": \"d\\n\\u00e9\"}]]}, \"\": \"\", \"e\": [1, [2, [3]]]}",
+    };
+    for (size_t i = 0; i < COUNT(inputs); ++i)
+    {
+        JTape tape;
+        size_t allocations = total_allocations;
+        TEST(json_parse_tape_custom(counting_alloc, free, inputs[i], JSON_NUL_TERMINATED, 0, &tape) == 1);
+        // the block, and a chunk to decode escaped strings in
+        TEST(total_allocations - allocations == (strchr(inputs[i], '\\') ? 2 : 1));
+        if (!TEST(tape_equals(json_tape_root(&tape), json_parse(inputs[i]))))
+            printf("input: '%s'\n", inputs[i]);
+        json_tape_free(&tape);
+        TEST(tape.words == 0 && json_tape_root(&tape).error == JSON_PARSE_ERROR);
+    }
+
+    // 2 words for a string or a scalar and 1 for a bracket, the bytes of
+    // strings and scalars with room for their terminators
+    jsize_t words;
+    jsize_t strings;
+    json_measure_tape("[1, \"ab\", true]", 15, &words, &strings);
+    TEST(words == 8 && strings == 10);
+    const char *escaped = "{\"a\\\"\": [\"{,}\"]}";
+    json_measure_tape(escaped, strlen(escaped), &words, &strings);
+    TEST(words == 8 && strings == 8);
+
+    char *input = read_file_as_str("tests/test_input.json");
+    JTape tape;
+    if (TEST(json_parse_tape(input, strlen(input), &tape) == 1))
+    {
+        TEST(tape_equals(json_tape_root(&tape), json_parse(input)));
+        JTapeValue root = json_tape_root(&tape);
+        JTapeValue array = json_tape_get(&root, "array");
+        JTapeValue nested = json_tape_get(&array, "test");
+        TEST(nested.error == JSON_TYPE_ERROR);
+        JTapeValue object = json_tape_at(&array, 5);
+        nested = json_tape_get(&object, "test");
+        JTapeValue first = json_tape_at(&nested, 0);
+        JTapeValue string = json_tape_get(&first, "nested");
+        JValue value = json_tape_value(&string);
+        if (TEST(value.type == JSON_STRING))
+            TEST(strcmp(value.string.data, "nested string") == 0);
+        TEST(json_tape_at(&array, 7).error == JSON_KEY_NOT_FOUND);
+        JTapeValue missing = json_tape_get(&root, "missing");
+        TEST(missing.error == JSON_KEY_NOT_FOUND);
+        TEST(json_tape_get(&missing, "deeper").error == JSON_KEY_NOT_FOUND);
+        TEST(json_tape_value(&array).error == JSON_TYPE_ERROR);
+
+        // a container and its close point at each other
+        jsize_t close = tape.words[array.index] & 0xFFFFFFFFFFFFFF;
+        TEST((char)(tape.words[close] >> 56) == ']' && (tape.words[close] & 0xFFFFFFFFFFFFFF) == array.index);
+    }
+    json_tape_free(&tape);
+    free(input);
+
+    JTape lazy;
+    if (TEST(json_parse_tape_custom(malloc, free, "[1.50]", 6, JSON_LAZY_NUMBERS, &lazy) == 1))
+    {
+        JTapeValue root = json_tape_root(&lazy);
+        JTapeValue number = json_tape_at(&root, 0);
+        JValue value = json_tape_value(&number);
+        TEST(value.type == JSON_RAW_NUMBER && value.string.length == 4 && strcmp(value.string.data, "1.50") == 0);
+    }
+    json_tape_free(&lazy);
+
+    const char *invalid[] = {"", "[1,]", "{\"a\" 1}", "[1, 2", "{\"a\": [}"};
+    for (size_t i = 0; i < COUNT(invalid); ++i)
+    {
+        TEST(json_parse_tape(invalid[i], strlen(invalid[i]), &tape) != 1);
+        TEST(json_tape_root(&tape).error == JSON_PARSE_ERROR);
+        json_tape_free(&tape);
+    }
+}
+
+int arena_chunks;
+int arena_allocations;
+
+void *arena_counted_alloc(size_t size)
+{
+    arena_chunks++;
+    arena_allocations++;
+    return malloc(size);
+}
+
+void arena_counted_free(void *ptr)
+{
+    arena_chunks--;
+    free(ptr);
+}
+
+void *arena_failing_alloc(size_t size)
+{
+    (void)size;
+    return 0;
+}
+
+void test_arena(void)
+{
+    arena_chunks = 0;
+    JArena arena = json_arena_init_custom(arena_counted_alloc, arena_counted_free);
+    TEST(arena_chunks == 0);
+
+    char *byte = (char *)json_arena_alloc(&arena, 1, 1);
+    double *aligned = (double *)json_arena_alloc(&arena, sizeof(double), 8);
+    char *wide = (char *)json_arena_alloc(&arena, 3, 64);
+    TEST(byte != 0 && aligned != 0 && wide != 0);
+    TEST(((uintptr_t)aligned & 7) == 0 && (char *)aligned > byte);
+    TEST(((uintptr_t)wide & 63) == 0);
+    TEST(arena_chunks == 1);
+
+    // bigger than the next chunk and the geometric growth
+    char *big = (char *)json_arena_alloc(&arena, JP_ARENA_CHUNK_SIZE * 3, 8);
+    TEST(big != 0 && arena_chunks == 2);
+    memset(big, 'x', JP_ARENA_CHUNK_SIZE * 3);
+    TEST(arena.chunk->capacity >= JP_ARENA_CHUNK_SIZE * 3);
+    json_arena_alloc(&arena, arena.chunk->capacity, 8);
+    TEST(arena_chunks == 3 && arena.next_capacity == arena.chunk->capacity * 2);
+
+    // the newest chunk stays and is reused
+    JArenaChunk *kept = arena.chunk;
+    json_arena_reset(&arena);
+    TEST(arena_chunks == 1 && arena.chunk == kept);
+    TEST((char *)json_arena_alloc(&arena, 16, 8) == (char *)(kept + 1));
+    TEST(arena_chunks == 1);
+
+    const char *input = "{\"a\": [1, \"two\", {\"b\\n\": null}], \"c\": 3.5}";
+    for (int i = 0; i < 4; ++i)
+    {
+        json_arena_reset(&arena);
+        JValue value = json_parse_arena(&arena, input, strlen(input), 0);
+        if (TEST(value.type == JSON_OBJECT))
+        {
+            JValue array = json_get(&value.object, "a");
+            if (TEST(array.type == JSON_ARRAY && array.array.length == 3))
+            {
+                TEST(strcmp(array.array.data[1].string.data, "two") == 0);
+                TEST(array.array.data[2].object.data[0].key_length == 2);
+            }
+            TEST(json_get(&value.object, "c").real == 3.5);
+        }
+        TEST(arena_chunks == 1);
+    }
+    JValue error = json_parse_arena(&arena, "[1,]", 4, 0);
+    TEST(error.type == JSON_ERROR && error.error == JSON_PARSE_ERROR);
+
+    // an empty chunk given up by json_arena_reserve leaves the allocations
+    // of the one before it alone
+    json_arena_free(&arena);
+    char *kept_data = (char *)json_arena_alloc(&arena, 16, 8);
+    memcpy(kept_data, "0123456789abcde", 16);
+    arena.next_capacity = 64;
+    TEST(json_arena_reserve(&arena, JP_ARENA_CHUNK_SIZE - 15) == 1 && arena.used == 0 && arena_chunks == 2);
+    // too big for the empty chunk, not for the whole of the first one
+    TEST(json_arena_reserve(&arena, JP_ARENA_CHUNK_SIZE - 6) == 1 && arena_chunks == 2);
+    char *reserved = (char *)json_arena_alloc(&arena, JP_ARENA_CHUNK_SIZE - 6, 1);
+    memset(reserved, 'x', JP_ARENA_CHUNK_SIZE - 6);
+    TEST(memcmp(kept_data, "0123456789abcde", 16) == 0);
+
+    // a reset keeps the largest chunk, also when it was adopted
+    JArena other = json_arena_init_custom(arena_counted_alloc, arena_counted_free);
+    json_arena_alloc(&other, JP_ARENA_CHUNK_SIZE * 4, 8);
+    JArenaChunk *largest = other.chunk;
+    json_arena_adopt(&arena, &other);
+    TEST(other.chunk == 0 && arena_chunks == 3);
+    json_arena_reset(&arena);
+    TEST(arena_chunks == 1 && arena.chunk == largest && arena.used == 0);
+    TEST((char *)json_arena_alloc(&arena, JP_ARENA_CHUNK_SIZE * 2, 8) == (char *)(largest + 1));
+
+    json_arena_free(&arena);
+    TEST(arena_chunks == 0 && arena.chunk == 0);
+    json_arena_free(&arena);
+    json_arena_reset(&arena);
+    TEST(arena_chunks == 0);
+
+    JArena failing = json_arena_init_custom(arena_failing_alloc, 0);
+    TEST(json_arena_alloc(&failing, 8, 8) == 0);
+    JValue value = json_parse_arena(&failing, "{\"k\":\"v\"}", 9, 0);
+    TEST(value.type == JSON_ERROR && value.error == JSON_MEMORY_ERROR);
+}
+
+void test_document(void)
+{
+    const char *input = "{\"a\": [1, \"two\", {\"b\": null}], \"c\": \"three\"}";
+    arena_chunks = 0;
+    JDocument document = json_parse_document_custom(arena_counted_alloc, arena_counted_free, input, strlen(input), 0);
+    if (TEST(document.root.type == JSON_OBJECT))
+    {
+        JValue array = json_get(&document.root.object, "a");
+        TEST(array.type == JSON_ARRAY && array.array.length == 3);
+        TEST(strcmp(json_get(&document.root.object, "c").string.data, "three") == 0);
+    }
+    TEST(arena_chunks == 1);
+    json_free(&document);
+    TEST(arena_chunks == 0 && document.root.type == JSON_NULL);
+    json_free(&document);
+    TEST(arena_chunks == 0);
+
+    // errors still own whatever was allocated before them
+    document = json_parse_document_custom(arena_counted_alloc, arena_counted_free, "[\"a\", 1,]", 10, 0);
+    TEST(document.root.type == JSON_ERROR && document.root.error == JSON_PARSE_ERROR);
+    json_free(&document);
+    TEST(arena_chunks == 0);
+
+    // the mapping outlives the zero copy strings until json_free
+    document = json_parse_document_file("tests/test_input.json", JSON_ZERO_COPY);
+    if (TEST(document.root.type == JSON_OBJECT))
+    {
+        JValue string = json_get(&document.root.object, "string");
+        if (TEST(string.type == JSON_STRING))
+        {
+            TEST(string.string.data > document.file.data && string.string.data < document.file.data + document.file.size);
+            TEST(string.string.length == 11 && memcmp(string.string.data, "test string", 11) == 0);
+        }
+    }
+    json_free(&document);
+    TEST(document.file.size == 0 && document.arena.chunk == 0);
+
+    document = json_parse_document_file("tests/missing.json", 0);
+    TEST(document.root.type == JSON_ERROR && document.root.error == JSON_FILE_ERROR);
+    json_free(&document);
+}
+
+void test_reuse(void)
+{
+    char big[8192];
+    size_t length = 0;
+    big[length++] = '[';
+    for (int i = 0; i < 500; ++i)
+        length += (size_t)sprintf(big + length, "%s\"s%d\"", i ? "," : "", i);
+    big[length++] = ']';
+    big[length] = '\0';
+    const char *small = "{\"a\": [1, 2, 3]}";
+
+    arena_chunks = 0;
+    JDocument document = json_init_document(json_arena_init_custom(arena_counted_alloc, arena_counted_free));
+    TEST(json_arena_capacity(&document.arena) == 0);
+    JValue root = json_parse_reuse(&document, big, length, 0);
+    TEST(root.type == JSON_ARRAY && root.array.length == 500);
+    TEST(arena_chunks > 1);
+    jsize_t high_water = json_arena_size(&document.arena);
+
+    // the chunks are merged into one that fits the whole input
+    root = json_parse_reuse(&document, big, length, 0);
+    TEST(root.type == JSON_ARRAY && strcmp(root.array.data[499].string.data, "s499") == 0);
+    TEST(arena_chunks == 1 && json_arena_capacity(&document.arena) >= high_water);
+    jsize_t capacity = json_arena_capacity(&document.arena);
+    arena_allocations = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        root = json_parse_reuse(&document, i % 2 ? small : big, i % 2 ? strlen(small) : length, 0);
+        TEST(root.type == (i % 2 ? JSON_OBJECT : JSON_ARRAY));
+    }
+    TEST(arena_allocations == 0 && json_arena_capacity(&document.arena) == capacity);
+    TEST(document.root.type == JSON_OBJECT && json_get(&document.root.object, "a").array.length == 3);
+
+    // a limit drops what a big input left behind
+    document.arena.retain_limit = JP_ARENA_CHUNK_SIZE;
+    root = json_parse_reuse(&document, small, strlen(small), 0);
+    TEST(root.type == JSON_OBJECT && json_arena_capacity(&document.arena) <= JP_ARENA_CHUNK_SIZE);
+    root = json_parse_reuse(&document, big, length, 0);
+    TEST(root.type == JSON_ARRAY && root.array.length == 500);
+    root = json_parse_reuse(&document, small, strlen(small), 0);
+    TEST(root.type == JSON_OBJECT && arena_chunks == 1);
+    TEST(json_arena_capacity(&document.arena) <= JP_ARENA_CHUNK_SIZE);
+
+    root = json_parse_reuse(&document, "[1,]", 4, 0);
+    TEST(root.type == JSON_ERROR && root.error == JSON_PARSE_ERROR);
+    json_free(&document);
+    TEST(arena_chunks == 0);
+}
+
 Test tests[] = {
     { .name = "values", .f = test_values },
     { .name = "errors", .f = test_errors },
@@ -302,6 +1826,27 @@ Test tests[] = {
     { .name = "memory error", .f = test_memory_error },
     { .name = "input", .f = test_input },
     { .name = "memory", .f = test_memory },
+    { .name = "nested", .f = test_nested },
+    { .name = "whitespaces", .f = test_whitespaces },
+    { .name = "escapes", .f = test_escapes },
+    { .name = "zero copy", .f = test_zero_copy },
+    { .name = "insitu", .f = test_insitu },
+    { .name = "length", .f = test_length },
+    { .name = "doubles", .f = test_doubles },
+    { .name = "integers", .f = test_integers },
+    { .name = "lazy numbers", .f = test_lazy_numbers },
+    { .name = "skip", .f = test_skip },
+    { .name = "cursor", .f = test_cursor },
+    { .name = "stream", .f = test_stream },
+    { .name = "lines", .f = test_lines },
+    { .name = "many", .f = test_many },
+    { .name = "parallel", .f = test_parallel },
+    { .name = "file", .f = test_file },
+    { .name = "sax", .f = test_sax },
+    { .name = "tape", .f = test_tape },
+    { .name = "arena", .f = test_arena },
+    { .name = "document", .f = test_document },
+    { .name = "reuse", .f = test_reuse },
 };
 
 int main(void)
@@ -72,10 +72,81 @@ void test_single_values()
         TEST(value.null == 0);
 }
 
+void test_cursor()
+{
+    const char *input = "{\"_id\": 6969, \"name\": \"Ciremun\", \"notifications\": {\"email\": false, \"push\": true}, "
+                        "\"links\": [\"a\", \"b\"]}";
+
+    JArena arena = json_arena_init();
+    JCursor json = json_cursor_begin(&arena, input, strlen(input));
+
+    long long id;
+    JCursor id_cursor = json["_id"];
+    TEST(json_cursor_get_int(&id_cursor, &id) == 1 && id == 6969);
+    int push;
+    JCursor push_cursor = json["notifications"]["push"];
+    TEST(json_cursor_get_bool(&push_cursor, &push) == 1 && push == 1);
+    JString link;
+    JCursor link_cursor = json["links"][1];
+    if (TEST(json_cursor_get_string(&link_cursor, &link) == 1))
+        TEST(link.length == 1 && link.data[0] == 'b');
+    TEST(json["deep"][6]["dark"].error == JSON_KEY_NOT_FOUND);
+    json_arena_free(&arena);
+}
+
+void test_tape()
+{
+    const char *input = "{\"_id\": 6969, \"notifications\": {\"email\": false, \"push\": true}, \"links\": [\"a\", \"b\"]}";
+
+    JTape tape;
+    if (!TEST(json_parse_tape(input, strlen(input), &tape) == 1))
+        return;
+    JTapeValue json = json_tape_root(&tape);
+
+    JTapeValue id = json["_id"];
+    TEST(json_tape_value(&id).number == 6969);
+    JTapeValue push = json["notifications"]["push"];
+    TEST(json_tape_value(&push).boolean == 1);
+    JTapeValue link = json["links"][1];
+    JValue link_value = json_tape_value(&link);
+    if (TEST(link_value.type == JSON_STRING))
+        TEST(link_value.string.length == 1 && link_value.string.data[0] == 'b');
+    TEST(json["deep"][6]["dark"].error == JSON_KEY_NOT_FOUND);
+    json_tape_free(&tape);
+}
+
+void test_document()
+{
+    const char *input = "{\"_id\": 6969, \"links\": [\"a\", \"b\"]}";
+
+    JScopedDocument document(json_parse_document(input, strlen(input), 0));
+    if (TEST(document->root.type == JSON_OBJECT))
+        TEST(document->root["_id"].number == 6969);
+    JArenaChunk *chunk = document->arena.chunk;
+    TEST(chunk != 0);
+
+    // moving hands the chunks over and leaves the old document empty
+    JScopedDocument moved(static_cast<JScopedDocument &&>(document));
+    TEST(moved->arena.chunk == chunk && document->arena.chunk == 0);
+    TEST(document->root.type == JSON_NULL);
+    TEST(moved->root["links"][1].string.data[0] == 'b');
+
+    JScopedDocument assigned;
+    TEST(assigned->root.type == JSON_NULL && assigned->arena.chunk == 0);
+    assigned = JScopedDocument(json_parse_document("[1, 2]", 6, 0));
+    TEST(assigned->root[1].number == 2);
+    assigned = static_cast<JScopedDocument &&>(moved);
+    TEST(assigned->arena.chunk == chunk && moved->arena.chunk == 0);
+    TEST(assigned->root["_id"].number == 6969);
+}
+
 Test tests[] = {
     {"errors", test_errors},
     {"values", test_values},
     {"single values", test_single_values},
+    {"cursor", test_cursor},
+    {"tape", test_tape},
+    {"document", test_document},
 };
 
 int main()
@@ -44,6 +44,14 @@ void *custom_alloc(unsigned long long int size)
     return test_memory_buffer_base - size;
 }
 
+size_t total_allocations = 0;
+
+void *counting_alloc(size_t size)
+{
+    total_allocations++;
+    return malloc(size);
+}
+
 void *returns_null(unsigned long long int size)
 {
     (void)size;